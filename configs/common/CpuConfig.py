@@ -62,3 +62,13 @@ def config_etrace(cpu_cls, cpu_list, options):
     else:
         fatal("%s does not support data dependency tracing. Use a CPU model of"
               " type or inherited from DerivO3CPU.", cpu_cls)
+
+def config_branch_trace(cpu_cls, cpu_list, options):
+    if not issubclass(cpu_cls, m5.objects.DerivO3CPU):
+        fatal("%s does not support branch tracing. Use a CPU model of"
+              " type or inherited from DerivO3CPU.", cpu_cls)
+    # The trace file name is prefixed with the name of the listener, so
+    # every cpu gets a trace of its own
+    for cpu in cpu_list:
+        cpu.branchTraceListener = m5.objects.BranchTrace(
+                                  traceFile = options.branch_trace_file)
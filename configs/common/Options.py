@@ -231,6 +231,10 @@ def addCommonOptions(parser):
                       help="""Data dependency trace file input to
                       Elastic Trace probe in a capture simulation and
                       Trace CPU in a replay simulation""", default="")
+    parser.add_option("--branch-trace-file", action="store", type="string",
+                      help="""Record the committed branches of O3 CPUs to
+                      this protobuf trace, for replay with
+                      bpred_trace_eval.py""", default="")
 
     parser.add_option("-l", "--lpae", action="store_true")
     parser.add_option("-V", "--virtualisation", action="store_true")
@@ -296,6 +300,10 @@ def addCommonOptions(parser):
                       help="Enable basic block profiling for SimPoints")
     parser.add_option("--simpoint-interval", type="int", default=10000000,
                       help="SimPoint interval in num of instructions")
+    parser.add_option("--simpoint-max-k", type="int", default=0,
+                      help="""Pick at most this many SimPoints with k-means at
+                      the end of profiling, writing the simpoints and
+                      weights files to the output directory""")
     parser.add_option("--take-simpoint-checkpoints", action="store", type="string",
         help="<simpoint file,weight file,interval-length,warmup-length>")
     parser.add_option("--restore-simpoint-checkpoint", action="store_true",
@@ -339,6 +347,26 @@ def addCommonOptions(parser):
     parser.add_option("-p", "--prog-interval", type="str",
         help="CPU Progress Interval")
 
+    # Sampled simulation
+    parser.add_option("--sample-period", action="store", type="int",
+        default=None,
+        help="""Measure a sample on --cpu-type every <N> instructions and
+                run the rest on --sample-functional-cpu""")
+    parser.add_option("--sample-warmup", action="store", type="int",
+        default=2000,
+        help="Detailed warm-up instructions before every sample")
+    parser.add_option("--sample-length", action="store", type="int",
+        default=1000, help="Instructions measured per sample")
+    parser.add_option("--sample-target-error", action="store", type="float",
+        default=0.0,
+        help="""Stop once the 99.7%% confidence interval of the CPI is
+                within this fraction of it (0 runs to completion)""")
+    parser.add_option("--sample-functional-cpu", action="store",
+        type="choice", default="AtomicSimpleCPU",
+        choices=ObjectList.cpu_list.get_names(),
+        help="""CPU running between samples; use a KVM CPU for speed at
+                the cost of cold caches""")
+
     # Fastforwarding and simpoint related materials
     parser.add_option("-W", "--warmup-insts", action="store", type="int",
         default=None,
@@ -87,6 +87,10 @@ def setCPUClass(options):
         CPUClass = TmpClass
         TmpClass = AtomicSimpleCPU
         test_mem_mode = 'atomic'
+    elif options.sample_period:
+        CPUClass = TmpClass
+        TmpClass, test_mem_mode = \
+            getCPUClass(options.sample_functional_cpu)
 
     # Ruby only supports atomic accesses in noncaching mode
     if test_mem_mode == 'atomic' and options.ruby:
@@ -431,6 +435,23 @@ def repeatSwitch(testsys, repeat_switch_cpu_list, maxtick, switch_freq):
             exit_event = m5.simulate(maxtick - m5.curTick())
             return exit_event
 
+def sampledSimulation(testsys, switch_cpu_list, maxtick):
+    # The sampling controller stops the simulation whenever it needs the
+    # cpus to be switched, and picks up once they are
+    to_detailed = switch_cpu_list
+    to_functional = [(new_cpu, old_cpu) for old_cpu, new_cpu in
+                     switch_cpu_list]
+    while True:
+        exit_event = m5.simulate(maxtick - m5.curTick())
+        exit_cause = exit_event.getCause()
+
+        if exit_cause == "sampling: switch to detailed":
+            m5.switchCpus(testsys, to_detailed, verbose=False)
+        elif exit_cause == "sampling: switch to functional":
+            m5.switchCpus(testsys, to_functional, verbose=False)
+        else:
+            return exit_event
+
 def run(options, root, testsys, cpu_class):
     if options.checkpoint_dir:
         cptdir = options.checkpoint_dir
@@ -451,6 +472,12 @@ def run(options, root, testsys, cpu_class):
     if options.repeat_switch and options.take_checkpoints:
         fatal("Can't specify both --repeat-switch and --take-checkpoints")
 
+    if options.sample_period and (options.fast_forward or
+            options.standard_switch or options.repeat_switch or
+            options.checkpoint_restore != None):
+        fatal("Can't combine --sample-period with --fast-forward, "
+              "--standard-switch, --repeat-switch or --checkpoint-restore")
+
     np = options.num_cpus
     switch_cpus = None
 
@@ -495,9 +522,22 @@ def run(options, root, testsys, cpu_class):
         if options.elastic_trace_en:
             CpuConfig.config_etrace(cpu_class, switch_cpus, options)
 
+        # Likewise for the branch trace probe
+        if options.branch_trace_file:
+            CpuConfig.config_branch_trace(cpu_class, switch_cpus, options)
+
         testsys.switch_cpus = switch_cpus
         switch_cpu_list = [(testsys.cpu[i], switch_cpus[i]) for i in range(np)]
 
+        if options.sample_period:
+            testsys.sampler = SamplingController(
+                functional_cpus = testsys.cpu,
+                detailed_cpus = switch_cpus,
+                period = options.sample_period,
+                warmup = options.sample_warmup,
+                length = options.sample_length,
+                target_error = options.sample_target_error)
+
     if options.repeat_switch:
         switch_class = getCPUClass(options.cpu_type)[0]
         if switch_class.require_caches() and \
@@ -657,7 +697,7 @@ def run(options, root, testsys, cpu_class):
         fatal("Bad maxtick (%d) specified: " \
               "Checkpoint starts starts from tick: %d", maxtick, cpt_starttick)
 
-    if options.standard_switch or cpu_class:
+    if (options.standard_switch or cpu_class) and not options.sample_period:
         if options.standard_switch:
             print("Switch at instruction count:%s" %
                     str(testsys.cpu[0].max_insts_any_thread))
@@ -721,7 +761,9 @@ def run(options, root, testsys, cpu_class):
 
         # If checkpoints are being taken, then the checkpoint instruction
         # will occur in the benchmark code it self.
-        if options.repeat_switch and maxtick > options.repeat_switch:
+        if options.sample_period:
+            exit_event = sampledSimulation(testsys, switch_cpu_list, maxtick)
+        elif options.repeat_switch and maxtick > options.repeat_switch:
             exit_event = repeatSwitch(testsys, repeat_switch_cpu_list,
                                       maxtick, options.repeat_switch)
         else:
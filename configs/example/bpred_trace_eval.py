@@ -0,0 +1,88 @@
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Replay a branch trace recorded with se.py --branch-trace-file against a
+# set of branch predictors and report the MPKI of each, e.g.
+#
+#   gem5.opt configs/example/bpred_trace_eval.py \
+#       --trace-file=m5out/system.cpu.branchTraceListener.branches.gz \
+#       --bp-types=TAGE_SC_L_64KB,MultiperspectivePerceptron64KB,BiModeBP
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import optparse
+import sys
+
+import m5
+from m5.objects import *
+from m5.util import addToPath, fatal
+
+addToPath('../')
+
+from common import ObjectList
+
+parser = optparse.OptionParser()
+
+parser.add_option("--trace-file", type="string", default="",
+                  help="Branch trace to replay")
+parser.add_option("--bp-types", type="string",
+                  default="TournamentBP,BiModeBP,LTAGE,TAGE_SC_L_64KB",
+                  help="Comma-separated list of branch predictors to "
+                  "evaluate, see --list-bp-types")
+parser.add_option("--list-bp-types", action="store_true",
+                  help="List available branch predictor types")
+parser.add_option("--host-threads", type="int", default=0,
+                  help="Number of host threads, 0 for one per predictor")
+parser.add_option("--max-branches", type="int", default=0,
+                  help="Number of branches to replay, 0 for all")
+
+(options, args) = parser.parse_args()
+
+if args:
+    print("Error: script doesn't take any positional arguments")
+    sys.exit(1)
+
+if options.list_bp_types:
+    ObjectList.bp_list.print()
+    sys.exit(0)
+
+if not options.trace_file:
+    fatal("Specify the branch trace to replay with --trace-file")
+
+predictors = [ ObjectList.bp_list.get(bp_type)()
+               for bp_type in options.bp_types.split(',') ]
+
+root = Root(full_system = False)
+root.bpred_eval = BranchTraceEval(traceFile = options.trace_file,
+                                  predictors = predictors,
+                                  hostThreads = options.host_threads,
+                                  maxBranches = options.max_branches)
+
+m5.instantiate()
+exit_event = m5.simulate()
+print('Exiting @ tick %i because %s' %
+      (m5.curTick(), exit_event.getCause()))
@@ -204,7 +204,8 @@ def build_test_system(np):
 
         for i in range(np):
             if options.simpoint_profile:
-                test_sys.cpu[i].addSimPointProbe(options.simpoint_interval)
+                test_sys.cpu[i].addSimPointProbe(options.simpoint_interval,
+                                                 options.simpoint_max_k)
             if options.checker:
                 test_sys.cpu[i].addCheckerCpu()
             if not ObjectList.is_kvm_cpu(TestCPUClass):
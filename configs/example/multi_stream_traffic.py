@@ -0,0 +1,126 @@
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Drive a set of memory channels with MultiStreamTrafficGen. Every
+# generator owns a number of channels, one stream and one SimpleMemory
+# each, and runs with its channels in its own event queue, so a run with
+# several generators exercises the parallel event queues.
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import argparse
+
+import m5
+from m5.objects import *
+from m5.util import convert, fatal
+
+parser = argparse.ArgumentParser(
+    description="Bandwidth test of memory channels driven by "
+                "MultiStreamTrafficGen")
+parser.add_argument("--generators", type=int, default=1,
+                    help="number of generators, each in its own event "
+                         "queue")
+parser.add_argument("--streams", type=int, default=4,
+                    help="number of streams (channels) per generator")
+parser.add_argument("--pattern", choices=["linear", "random"],
+                    default="linear", help="address pattern")
+parser.add_argument("--read-percent", type=int, default=100,
+                    help="percentage of reads")
+parser.add_argument("--period", default="1ns",
+                    help="time between requests of a stream")
+parser.add_argument("--channel-size", default="16MB",
+                    help="size of the memory behind each stream")
+parser.add_argument("--data-limit", default="1MB",
+                    help="bytes each stream transfers")
+parser.add_argument("--mem-latency", default="30ns",
+                    help="latency of the channel memories")
+parser.add_argument("--mem-bandwidth", default="12.8GB/s",
+                    help="bandwidth of each channel memory")
+parser.add_argument("--quantum", default="1us",
+                    help="simulation quantum with several generators")
+
+options = parser.parse_args()
+
+if options.generators < 1 or options.streams < 1:
+    fatal("Need at least one generator with at least one stream.")
+
+system = System(mem_mode = 'timing')
+system.clk_domain = SrcClockDomain(clock = '1GHz',
+                                   voltage_domain = VoltageDomain())
+
+channel_size = convert.toMemorySize(options.channel_size)
+gen_size = channel_size * options.streams
+
+gens = []
+mems = []
+for g in range(options.generators):
+    gen = MultiStreamTrafficGen(pattern = options.pattern,
+                                start_addr = g * gen_size,
+                                end_addr = (g + 1) * gen_size,
+                                period = options.period,
+                                read_percent = options.read_percent,
+                                data_limit = options.data_limit,
+                                seed = g + 1,
+                                eventq_index = g)
+    for s in range(options.streams):
+        base = g * gen_size + s * channel_size
+        mem = SimpleMemory(range = AddrRange(base, size = channel_size),
+                           latency = options.mem_latency,
+                           bandwidth = options.mem_bandwidth,
+                           eventq_index = g)
+        gen.port = mem.port
+        mems.append(mem)
+    gens.append(gen)
+
+system.generators = gens
+system.channels = mems
+system.mem_ranges = [ AddrRange(options.generators * gen_size) ]
+
+# Nothing uses the system port, but it has to be connected
+system.scratch = SimpleMemory(range = AddrRange(options.generators *
+                                                 gen_size, size = '4kB'))
+system.system_port = system.scratch.port
+
+root = Root(full_system = False, system = system)
+if options.generators > 1:
+    # The channels of different generators never talk to each other, so
+    # the quantum only bounds how far the threads drift apart
+    m5.ticks.fixGlobalFrequency()
+    root.sim_quantum = m5.ticks.fromSeconds(
+        convert.anyToLatency(options.quantum))
+
+m5.instantiate()
+
+# Every generator leaves the simulation loop once its streams are done
+done = 0
+while done < options.generators:
+    exit_event = m5.simulate()
+    if not exit_event.getCause().endswith("has completed all its streams."):
+        break
+    done += 1
+
+print('Exiting @ tick', m5.curTick(), 'because', exit_event.getCause())
@@ -198,6 +198,11 @@ system.cpu_clk_domain = SrcClockDomain(clock = options.cpu_clock,
 if options.elastic_trace_en:
     CpuConfig.config_etrace(CPUClass, system.cpu, options)
 
+# If branch tracing is enabled, attach the branch trace probe. When
+# switching cpus, the switch cpus get it instead.
+if options.branch_trace_file and not FutureClass:
+    CpuConfig.config_branch_trace(CPUClass, system.cpu, options)
+
 # All cpus belong to a common cpu_clk_domain, therefore running at a common
 # frequency.
 for cpu in system.cpu:
@@ -228,7 +233,8 @@ for i in range(np):
         system.cpu[i].workload = multiprocesses[i]
 
     if options.simpoint_profile:
-        system.cpu[i].addSimPointProbe(options.simpoint_interval)
+        system.cpu[i].addSimPointProbe(options.simpoint_interval,
+                                       options.simpoint_max_k)
 
     if options.checker:
         system.cpu[i].addCheckerCpu()
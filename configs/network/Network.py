@@ -74,6 +74,11 @@ def define_options(parser):
     parser.add_option("--garnet-deadlock-threshold", action="store",
                       type="int", default=50000,
                       help="network-level deadlock threshold.")
+    parser.add_option("--garnet-threads", action="store", type="int",
+                      default=1,
+                      help="""number of host threads simulating the garnet
+                            routers and network interfaces. Controllers
+                            stay on the main thread.""")
 
 
 def create_network(options, ruby):
@@ -117,7 +122,53 @@ def init_network(options, network, InterfaceClass):
                   for (i,n) in enumerate(network.ext_links)]
         network.netifs = netifs
 
+    if options.network == "garnet2.0" and options.garnet_threads > 1:
+        network.garnet_threads = options.garnet_threads
+        partition_network(options, network)
+
     if options.network_fault_model:
         assert(options.network == "garnet2.0")
         network.enable_fault_model = True
         network.fault_model = FaultModel()
+
+def partition_network(options, network):
+    """Spread the garnet routers over options.garnet_threads event queues.
+
+    Routers are split into contiguous blocks of router ids, which keeps
+    mesh rows together. Each network interface runs with the router it is
+    attached to, and event queue 0 keeps the controllers. Every link runs
+    on the queue of the component feeding it, so threads only share link
+    buffers and the protocol buffers between the NIs and the controllers.
+    Neither can be read before the cycle after it was written, so the
+    threads synchronise once per network cycle unless the config sets a
+    smaller Root.sim_quantum.
+    """
+
+    num_routers = len(network.routers)
+    num_threads = min(options.garnet_threads, num_routers)
+
+    def router_eq(router):
+        return 1 + int(router.router_id) * num_threads // num_routers
+
+    for router in network.routers:
+        router.eventq_index = router_eq(router)
+
+    for link in network.int_links:
+        if int(link.latency) < 1:
+            fatal("Parallel garnet needs link latencies of at least one "
+                  "cycle, link %d has %d." %
+                  (int(link.link_id), int(link.latency)))
+        link.network_link.eventq_index = router_eq(link.src_node)
+        # Credits flow back from the downstream router
+        link.credit_link.eventq_index = router_eq(link.dst_node)
+
+    # init_network() creates one NI per external link, in the same order
+    for link, netif in zip(network.ext_links, network.netifs):
+        if int(link.latency) < 1:
+            fatal("Parallel garnet needs link latencies of at least one "
+                  "cycle, link %d has %d." %
+                  (int(link.link_id), int(link.latency)))
+        router_queue = router_eq(link.int_node)
+        netif.eventq_index = router_queue
+        for ext_link in link.network_links + link.credit_links:
+            ext_link.eventq_index = router_queue
@@ -565,7 +565,7 @@ TLB::translateSe(const RequestPtr &req, ThreadContext *tc, Mode mode,
     Addr paddr;
     Process *p = tc->getProcessPtr();
 
-    if (!p->pTable->translate(vaddr, paddr))
+    if (!p->pTable->translate(vaddr, paddr, microTlb))
         return std::make_shared<GenericPageTableFault>(vaddr_tainted);
     req->setPaddr(paddr);
 
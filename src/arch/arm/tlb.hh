@@ -48,6 +48,7 @@
 #include "arch/arm/utility.hh"
 #include "arch/generic/tlb.hh"
 #include "base/statistics.hh"
+#include "mem/page_table.hh"
 #include "mem/request.hh"
 #include "params/ArmTLB.hh"
 #include "sim/probe/pmu.hh"
@@ -160,6 +161,9 @@ class TLB : public BaseTLB
 
     TlbTestInterface *test;
 
+    /** Cache of the page table used by translateSe(). */
+    EmulationPageTable::MicroTlb microTlb;
+
     // Access Stats
     mutable Stats::Scalar instHits;
     mutable Stats::Scalar instMisses;
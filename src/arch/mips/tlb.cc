@@ -278,7 +278,7 @@ Fault
 TLB::translateAtomic(const RequestPtr &req, ThreadContext *tc, Mode mode)
 {
     panic_if(FullSystem, "translateAtomic not implemented in full system.");
-    return tc->getProcessPtr()->pTable->translate(req);
+    return tc->getProcessPtr()->pTable->translate(req, microTlb);
 }
 
 void
@@ -37,6 +37,7 @@
 #include "arch/mips/pagetable.hh"
 #include "arch/mips/utility.hh"
 #include "base/statistics.hh"
+#include "mem/page_table.hh"
 #include "mem/request.hh"
 #include "params/MipsTLB.hh"
 #include "sim/sim_object.hh"
@@ -58,6 +59,8 @@ class TLB : public BaseTLB
     int size;                   // TLB Size
     int nlu;                    // not last used entry (for replacement)
 
+    EmulationPageTable::MicroTlb microTlb; // SE-mode page table cache
+
     void nextnlu() { if (++nlu >= size) nlu = 0; }
     MipsISA::PTE *lookup(Addr vpn, uint8_t asn) const;
 
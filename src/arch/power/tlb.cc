@@ -282,13 +282,13 @@ TLB::translateInst(const RequestPtr &req, ThreadContext *tc)
         return std::make_shared<AlignmentFault>();
     }
 
-    return tc->getProcessPtr()->pTable->translate(req);
+    return tc->getProcessPtr()->pTable->translate(req, microTlb);
 }
 
 Fault
 TLB::translateData(const RequestPtr &req, ThreadContext *tc, bool write)
 {
-    return tc->getProcessPtr()->pTable->translate(req);
+    return tc->getProcessPtr()->pTable->translate(req, microTlb);
 }
 
 Fault
@@ -39,6 +39,7 @@
 #include "arch/power/pagetable.hh"
 #include "arch/power/utility.hh"
 #include "base/statistics.hh"
+#include "mem/page_table.hh"
 #include "mem/request.hh"
 #include "params/PowerTLB.hh"
 
@@ -100,6 +101,8 @@ class TLB : public BaseTLB
     int size;                   // TLB Size
     int nlu;                    // not last used entry (for replacement)
 
+    EmulationPageTable::MicroTlb microTlb; // SE-mode page table cache
+
     void
     nextnlu()
     {
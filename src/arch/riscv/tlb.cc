@@ -376,7 +376,7 @@ TLB::translate(const RequestPtr &req, ThreadContext *tc,
 
         Process * p = tc->getProcessPtr();
 
-        Fault fault = p->pTable->translate(req);
+        Fault fault = p->pTable->translate(req, microTlb);
         if (fault != NoFault)
             return fault;
 
@@ -39,6 +39,7 @@
 #include "arch/riscv/pagetable.hh"
 #include "arch/riscv/utility.hh"
 #include "base/statistics.hh"
+#include "mem/page_table.hh"
 #include "mem/request.hh"
 #include "params/RiscvTLB.hh"
 #include "sim/sim_object.hh"
@@ -64,6 +65,8 @@ class TLB : public BaseTLB
 
     Walker *walker;
 
+    EmulationPageTable::MicroTlb microTlb; // SE-mode page table cache
+
     mutable Stats::Scalar read_hits;
     mutable Stats::Scalar read_misses;
     mutable Stats::Scalar read_acv;
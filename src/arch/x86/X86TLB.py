@@ -38,6 +38,7 @@ from m5.proxy import *
 
 from m5.objects.BaseTLB import BaseTLB
 from m5.objects.ClockedObject import ClockedObject
+from m5.objects.ReplacementPolicies import *
 
 class X86PagetableWalker(ClockedObject):
     type = 'X86PagetableWalker'
@@ -52,7 +53,31 @@ class X86TLB(BaseTLB):
     type = 'X86TLB'
     cxx_class = 'X86ISA::TLB'
     cxx_header = 'arch/x86/tlb.hh'
-    size = Param.Unsigned(64, "TLB size")
+    size = Param.Unsigned(64, "Number of L1 TLB entries for 4KB pages")
+    assoc = Param.Unsigned(0, "Associativity of the L1 TLB for 4KB pages "
+            "(0 means fully associative)")
+    large_size = Param.Unsigned(0,
+            "Number of L1 TLB entries for 2MB and 4MB pages (0 keeps them "
+            "in the L1 TLB for 4KB pages)")
+    large_assoc = Param.Unsigned(0, "Associativity of the L1 TLB for 2MB "
+            "and 4MB pages (0 means fully associative)")
+    huge_size = Param.Unsigned(0, "Number of L1 TLB entries for 1GB pages "
+            "(0 keeps them in the L1 TLB for large pages, or for 4KB pages "
+            "if there is none)")
+    huge_assoc = Param.Unsigned(0, "Associativity of the L1 TLB for 1GB "
+            "pages (0 means fully associative)")
+    l2_size = Param.Unsigned(0, "Number of entries of the unified L2 TLB, "
+            "shared by all page sizes (0 disables it)")
+    l2_assoc = Param.Unsigned(8, "Associativity of the L2 TLB "
+            "(0 means fully associative)")
+    replacement_policy = Param.BaseReplacementPolicy(LRURP(),
+            "Replacement policy of the L1 TLB for 4KB pages")
+    large_replacement_policy = Param.BaseReplacementPolicy(LRURP(),
+            "Replacement policy of the L1 TLB for 2MB and 4MB pages")
+    huge_replacement_policy = Param.BaseReplacementPolicy(LRURP(),
+            "Replacement policy of the L1 TLB for 1GB pages")
+    l2_replacement_policy = Param.BaseReplacementPolicy(LRURP(),
+            "Replacement policy of the L2 TLB")
     system = Param.System(Parent.any, "system object")
     walker = Param.X86PagetableWalker(\
             X86PagetableWalker(), "page table walker")
@@ -59,84 +59,192 @@
 
 namespace X86ISA {
 
-TLB::TLB(const Params *p)
-    : BaseTLB(p), configAddress(0), size(p->size),
-      tlb(size), lruSeq(0), m5opRange(p->system->m5opRange())
+TlbArray::TlbArray()
+    : assoc(0), setMask(0), replPolicy(nullptr), sizesPresent(0)
 {
-    if (!size)
-        fatal("TLBs must have a non-zero size.\n");
+    sizeCount.fill(0);
+}
 
-    for (int x = 0; x < size; x++) {
-        tlb[x].trieHandle = NULL;
-        freeList.push_back(&tlb[x]);
+void
+TlbArray::init(const std::string &name, unsigned entries, unsigned _assoc,
+               BaseReplacementPolicy *policy)
+{
+    if (!entries)
+        return;
+
+    assoc = _assoc ? _assoc : entries;
+    fatal_if(entries % assoc, "%s: %d entries are not a multiple of the "
+             "associativity (%d).\n", name, entries, assoc);
+    const unsigned num_sets = entries / assoc;
+    fatal_if(!isPowerOf2(num_sets), "%s: the number of sets (%d) must be a "
+             "power of two.\n", name, num_sets);
+    setMask = num_sets - 1;
+    replPolicy = policy;
+
+    tags.assign(entries, 0);
+    ways.resize(entries);
+    // Instantiate the replacement data set by set, as tree-based
+    // policies share it between the ways of a set.
+    for (unsigned i = 0; i < entries; i++) {
+        ways[i].setPosition(i / assoc, i % assoc);
+        ways[i].replacementData = replPolicy->instantiateEntry();
     }
+    candidates.reserve(assoc);
+}
 
-    walker = p->walker;
-    walker->setTLB(this);
+TlbArray::Way *
+TlbArray::lookup(Addr va)
+{
+    for (uint64_t sizes = sizesPresent; sizes; sizes &= sizes - 1) {
+        const unsigned log_bytes = findLsbSet(sizes);
+        const Addr tag = makeTag(va, log_bytes);
+        const unsigned first = ((va >> log_bytes) & setMask) * assoc;
+        for (unsigned i = first; i < first + assoc; i++) {
+            if (tags[i] == tag)
+                return &ways[i];
+        }
+    }
+    return nullptr;
+}
+
+TlbArray::Way *
+TlbArray::insert(const TlbEntry &entry)
+{
+    assert(enabled());
+    const unsigned log_bytes = entry.logBytes;
+    assert(log_bytes > 0 && log_bytes < 64);
+    const unsigned first = ((entry.vaddr >> log_bytes) & setMask) * assoc;
+
+    unsigned idx = first;
+    while (idx < first + assoc && tags[idx])
+        idx++;
+    if (idx == first + assoc) {
+        candidates.clear();
+        for (unsigned i = first; i < first + assoc; i++)
+            candidates.push_back(&ways[i]);
+        Way *victim = static_cast<Way *>(replPolicy->getVictim(candidates));
+        idx = victim - ways.data();
+        invalidate(idx);
+    }
+
+    Way &way = ways[idx];
+    way.entry = entry;
+    way.entry.vaddr &= ~mask(log_bytes);
+    tags[idx] = makeTag(entry.vaddr, log_bytes);
+    if (sizeCount[log_bytes]++ == 0)
+        sizesPresent |= ULL(1) << log_bytes;
+    replPolicy->reset(way.replacementData);
+    return &way;
 }
 
 void
-TLB::evictLRU()
+TlbArray::invalidate(unsigned idx)
 {
-    // Find the entry with the lowest (and hence least recently updated)
-    // sequence number.
+    const unsigned log_bytes = tags[idx] & mask(6);
+    assert(sizeCount[log_bytes]);
+    if (--sizeCount[log_bytes] == 0)
+        sizesPresent &= ~(ULL(1) << log_bytes);
+    tags[idx] = 0;
+    replPolicy->invalidate(ways[idx].replacementData);
+}
 
-    unsigned lru = 0;
-    for (unsigned i = 1; i < size; i++) {
-        if (tlb[i].lruSeq < tlb[lru].lruSeq)
-            lru = i;
-    }
+void
+TlbArray::demap(Addr va)
+{
+    Way *way = lookup(va);
+    if (way)
+        invalidate(way - ways.data());
+}
+
+TLB::TLB(const Params *p)
+    : BaseTLB(p), configAddress(0), lastHit(nullptr),
+      m5opRange(p->system->m5opRange())
+{
+    if (!p->size)
+        fatal("%s: the L1 TLB must have a non-zero size.\n", name());
+
+    // Each array has its own policy, as tree-based policies share their
+    // replacement data between the ways of a set.
+    smallL1.init(name() + ".l1", p->size, p->assoc, p->replacement_policy);
+    largeL1.init(name() + ".l1_large", p->large_size, p->large_assoc,
+                 p->large_replacement_policy);
+    hugeL1.init(name() + ".l1_huge", p->huge_size, p->huge_assoc,
+                p->huge_replacement_policy);
+    l2.init(name() + ".l2", p->l2_size, p->l2_assoc,
+            p->l2_replacement_policy);
 
-    assert(tlb[lru].trieHandle);
-    trie.remove(tlb[lru].trieHandle);
-    tlb[lru].trieHandle = NULL;
-    freeList.push_back(&tlb[lru]);
+    walker = p->walker;
+    walker->setTLB(this);
+}
+
+TlbArray::Way *
+TLB::lookupL1(Addr va)
+{
+    TlbArray::Way *way = smallL1.lookup(va);
+    if (!way)
+        way = largeL1.lookup(va);
+    if (!way)
+        way = hugeL1.lookup(va);
+    return way;
 }
 
 TlbEntry *
 TLB::insert(Addr vpn, const TlbEntry &entry)
 {
     // If somebody beat us to it, just use that existing entry.
-    TlbEntry *newEntry = trie.lookup(vpn);
-    if (newEntry) {
-        assert(newEntry->vaddr == vpn);
-        return newEntry;
+    TlbArray::Way *way = lookupL1(vpn);
+    if (way) {
+        assert(way->entry.vaddr == vpn);
+        return &way->entry;
     }
 
-    if (freeList.empty())
-        evictLRU();
-
-    newEntry = freeList.front();
-    freeList.pop_front();
-
-    *newEntry = entry;
-    newEntry->lruSeq = nextSeq();
-    newEntry->vaddr = vpn;
-    newEntry->trieHandle =
-    trie.insert(vpn, TlbEntryTrie::MaxBits - entry.logBytes, newEntry);
-    return newEntry;
+    TlbEntry new_entry = entry;
+    new_entry.vaddr = vpn;
+    // Fill both levels, the second one does not have to hold everything
+    // the first one does.
+    if (l2.enabled() && !l2.lookup(vpn))
+        l2.insert(new_entry);
+    lastHit = l1For(new_entry.logBytes).insert(new_entry);
+    return &lastHit->entry;
 }
 
 TlbEntry *
 TLB::lookup(Addr va, bool update_lru)
 {
-    TlbEntry *entry = trie.lookup(va);
-    if (entry && update_lru)
-        entry->lruSeq = nextSeq();
-    return entry;
+    TlbArray::Way *way = lastHit;
+    if (!way || va - way->entry.vaddr >= (ULL(1) << way->entry.logBytes)) {
+        way = lookupL1(va);
+        if (!way && l2.enabled()) {
+            TlbArray::Way *l2_way = l2.lookup(va);
+            if (l2_way) {
+                l2Hits++;
+                if (update_lru)
+                    l2.touch(l2_way);
+                way = l1For(l2_way->entry.logBytes).insert(l2_way->entry);
+            } else {
+                l2Misses++;
+            }
+        }
+        if (!way)
+            return nullptr;
+        lastHit = way;
+    }
+
+    if (update_lru)
+        l1For(way->entry.logBytes).touch(way);
+    return &way->entry;
 }
 
 void
 TLB::flushAll()
 {
     DPRINTF(TLB, "Invalidating all entries.\n");
-    for (unsigned i = 0; i < size; i++) {
-        if (tlb[i].trieHandle) {
-            trie.remove(tlb[i].trieHandle);
-            tlb[i].trieHandle = NULL;
-            freeList.push_back(&tlb[i]);
-        }
-    }
+    auto all = [](const TlbEntry &) { return true; };
+    smallL1.invalidateIf(all);
+    largeL1.invalidateIf(all);
+    hugeL1.invalidateIf(all);
+    l2.invalidateIf(all);
+    lastHit = nullptr;
 }
 
 void
@@ -149,24 +257,22 @@ void
 TLB::flushNonGlobal()
 {
     DPRINTF(TLB, "Invalidating all non global entries.\n");
-    for (unsigned i = 0; i < size; i++) {
-        if (tlb[i].trieHandle && !tlb[i].global) {
-            trie.remove(tlb[i].trieHandle);
-            tlb[i].trieHandle = NULL;
-            freeList.push_back(&tlb[i]);
-        }
-    }
+    auto non_global = [](const TlbEntry &entry) { return !entry.global; };
+    smallL1.invalidateIf(non_global);
+    largeL1.invalidateIf(non_global);
+    hugeL1.invalidateIf(non_global);
+    l2.invalidateIf(non_global);
+    lastHit = nullptr;
 }
 
 void
 TLB::demapPage(Addr va, uint64_t asn)
 {
-    TlbEntry *entry = trie.lookup(va);
-    if (entry) {
-        trie.remove(entry->trieHandle);
-        entry->trieHandle = NULL;
-        freeList.push_back(entry);
-    }
+    smallL1.demap(va);
+    largeL1.demap(va);
+    hugeL1.demap(va);
+    l2.demap(va);
+    lastHit = nullptr;
 }
 
 namespace
@@ -539,43 +645,56 @@ TLB::regStats()
         .name(name() + ".wrMisses")
         .desc("TLB misses on write requests");
 
+    l2Hits
+        .name(name() + ".l2Hits")
+        .desc("First level TLB misses that hit in the second level");
+
+    l2Misses
+        .name(name() + ".l2Misses")
+        .desc("First level TLB misses that also missed in the second level");
+
 }
 
 void
 TLB::serialize(CheckpointOut &cp) const
 {
-    // Only store the entries in use.
-    uint32_t _size = size - freeList.size();
+    // Store the second level first, so that restoring the entries in
+    // order leaves the first level with its own contents.
+    std::vector<const TlbEntry *> entries;
+    auto add = [&entries](const TlbEntry &entry) {
+        entries.push_back(&entry);
+    };
+    l2.forEachValid(add);
+    smallL1.forEachValid(add);
+    largeL1.forEachValid(add);
+    hugeL1.forEachValid(add);
+
+    uint32_t _size = entries.size();
     SERIALIZE_SCALAR(_size);
-    SERIALIZE_SCALAR(lruSeq);
 
-    uint32_t _count = 0;
-    for (uint32_t x = 0; x < size; x++) {
-        if (tlb[x].trieHandle != NULL)
-            tlb[x].serializeSection(cp, csprintf("Entry%d", _count++));
-    }
+    for (uint32_t x = 0; x < _size; x++)
+        entries[x]->serializeSection(cp, csprintf("Entry%d", x));
 }
 
 void
 TLB::unserialize(CheckpointIn &cp)
 {
-    // Do not allow to restore with a smaller tlb.
+    // Entries that do not fit any more, e.g. when restoring into a
+    // smaller TLB, are evicted by the replacement policy as they are
+    // inserted.
     uint32_t _size;
     UNSERIALIZE_SCALAR(_size);
-    if (_size > size) {
-        fatal("TLB size less than the one in checkpoint!");
-    }
-
-    UNSERIALIZE_SCALAR(lruSeq);
 
     for (uint32_t x = 0; x < _size; x++) {
-        TlbEntry *newEntry = freeList.front();
-        freeList.pop_front();
-
-        newEntry->unserializeSection(cp, csprintf("Entry%d", x));
-        newEntry->trieHandle = trie.insert(newEntry->vaddr,
-            TlbEntryTrie::MaxBits - newEntry->logBytes, newEntry);
+        TlbEntry entry;
+        entry.unserializeSection(cp, csprintf("Entry%d", x));
+        TlbArray &l1 = l1For(entry.logBytes);
+        if (!l1.lookup(entry.vaddr))
+            l1.insert(entry);
+        if (l2.enabled() && !l2.lookup(entry.vaddr))
+            l2.insert(entry);
     }
+    lastHit = nullptr;
 }
 
 Port *
@@ -38,12 +38,15 @@
 #ifndef __ARCH_X86_TLB_HH__
 #define __ARCH_X86_TLB_HH__
 
-#include <list>
+#include <array>
+#include <string>
 #include <vector>
 
 #include "arch/generic/tlb.hh"
 #include "arch/x86/pagetable.hh"
-#include "base/trie.hh"
+#include "base/bitfield.hh"
+#include "mem/cache/replacement_policies/base.hh"
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/request.hh"
 #include "params/X86TLB.hh"
 #include "sim/stats.hh"
@@ -54,13 +57,111 @@ namespace X86ISA
 {
     class Walker;
 
+    /**
+     * One level of TLB storage. Entries live in a flat, set-associative
+     * array and victims are picked by a replacement policy. Entries of
+     * different page sizes may share an array: each is indexed with its
+     * own page number, and a lookup probes one set per page size that is
+     * currently held.
+     */
+    class TlbArray
+    {
+      public:
+        struct Way : public ReplaceableEntry
+        {
+            TlbEntry entry;
+        };
+
+      private:
+        /**
+         * Per-way tags, kept apart from the entries so that a set is
+         * searched without touching them. A tag is the page-aligned
+         * virtual address with the page size (log2) in its low bits, or
+         * zero for an invalid way.
+         */
+        std::vector<Addr> tags;
+        std::vector<Way> ways;
+
+        unsigned assoc;
+        Addr setMask;
+
+        BaseReplacementPolicy *replPolicy;
+
+        /** Bit n is set if entries of 2^n byte pages are present. */
+        uint64_t sizesPresent;
+        std::array<uint32_t, 64> sizeCount;
+
+        /** Scratch candidate list, to avoid allocating on every fill. */
+        ReplacementCandidates candidates;
+
+        static Addr
+        makeTag(Addr va, unsigned log_bytes)
+        {
+            return (va & ~mask(log_bytes)) | log_bytes;
+        }
+
+        void invalidate(unsigned idx);
+
+      public:
+        TlbArray();
+
+        /**
+         * Allocate the storage of the array.
+         *
+         * @param name Name used in error messages.
+         * @param entries Number of entries, zero disables the array.
+         * @param assoc Associativity, zero for fully associative.
+         * @param policy Replacement policy used to pick victims.
+         */
+        void init(const std::string &name, unsigned entries, unsigned assoc,
+                  BaseReplacementPolicy *policy);
+
+        bool enabled() const { return !ways.empty(); }
+
+        /** Find the entry translating va, if there is one. */
+        Way *lookup(Addr va);
+
+        /**
+         * Insert an entry that is not in the array yet, evicting another
+         * one if its set is full.
+         */
+        Way *insert(const TlbEntry &entry);
+
+        /** Invalidate every entry for which pred returns true. */
+        template <class Pred>
+        void
+        invalidateIf(Pred pred)
+        {
+            if (!sizesPresent)
+                return;
+            for (unsigned i = 0; i < ways.size(); i++) {
+                if (tags[i] && pred(ways[i].entry))
+                    invalidate(i);
+            }
+        }
+
+        /** Invalidate the entry translating va, if there is one. */
+        void demap(Addr va);
+
+        /** Update the replacement data of a way on a hit. */
+        void touch(Way *way) { replPolicy->touch(way->replacementData); }
+
+        template <class Visitor>
+        void
+        forEachValid(Visitor visitor) const
+        {
+            for (unsigned i = 0; i < ways.size(); i++) {
+                if (tags[i])
+                    visitor(ways[i].entry);
+            }
+        }
+    };
+
     class TLB : public BaseTLB
     {
       protected:
         friend class Walker;
 
-        typedef std::list<TlbEntry *> EntryList;
-
         uint32_t configAddress;
 
       public:
@@ -76,8 +177,6 @@ namespace X86ISA
 
       protected:
 
-        EntryList::iterator lookupIt(Addr va, bool update_lru = true);
-
         Walker * walker;
 
       public:
@@ -90,22 +189,47 @@ namespace X86ISA
         void demapPage(Addr va, uint64_t asn) override;
 
       protected:
-        uint32_t size;
-
-        std::vector<TlbEntry> tlb;
+        /**
+         * First level TLBs for 4KB, large (2MB/4MB) and 1GB pages. The
+         * large and huge page ones are optional, their pages are held by
+         * the next smaller enabled one otherwise.
+         */
+        TlbArray smallL1;
+        TlbArray largeL1;
+        TlbArray hugeL1;
 
-        EntryList freeList;
+        /** Optional unified second level TLB, backing all L1 TLBs. */
+        TlbArray l2;
 
-        TlbEntryTrie trie;
-        uint64_t lruSeq;
+        /**
+         * The way that produced the last translation. Consecutive
+         * accesses mostly fall in the same page, so this is checked
+         * before any set is searched. It is cleared whenever an entry
+         * may be removed from the first level.
+         */
+        TlbArray::Way *lastHit;
 
         AddrRange m5opRange;
 
+        TlbArray &
+        l1For(unsigned log_bytes)
+        {
+            if (log_bytes >= 30 && hugeL1.enabled())
+                return hugeL1;
+            if (log_bytes > PageShift && largeL1.enabled())
+                return largeL1;
+            return smallL1;
+        }
+
+        TlbArray::Way *lookupL1(Addr va);
+
         // Statistics
         Stats::Scalar rdAccesses;
         Stats::Scalar wrAccesses;
         Stats::Scalar rdMisses;
         Stats::Scalar wrMisses;
+        Stats::Scalar l2Hits;
+        Stats::Scalar l2Misses;
 
         Fault translateInt(bool read, RequestPtr req, ThreadContext *tc);
 
@@ -115,14 +239,6 @@ namespace X86ISA
 
       public:
 
-        void evictLRU();
-
-        uint64_t
-        nextSeq()
-        {
-            return ++lruSeq;
-        }
-
         Fault translateAtomic(
             const RequestPtr &req, ThreadContext *tc, Mode mode) override;
         Fault translateFunctional(
@@ -46,6 +46,7 @@
 #include <list>
 #include <map>
 #include <utility>
+#include <vector>
 
 #include "base/addr_range.hh"
 #include "base/types.hh"
@@ -54,6 +55,15 @@
  * The AddrRangeMap uses an STL map to implement an interval tree for
  * address decoding. The value stored is a template type and can be
  * e.g. a port identifier, or a pointer.
+ *
+ * Most maps are built once and then only read, e.g. the memory map of
+ * a crossbar. Once a map has been looked up about as many times as it
+ * has entries without being changed, it is compiled into a sorted
+ * array of range start addresses that single-range lookups search
+ * with a branchless binary search. Interleaved ranges that together
+ * cover one span of addresses share a single slot of the array. Any
+ * change to the map discards the array, and lookups go back to the
+ * tree until the map has been read often enough to rebuild it.
  */
 template <typename V, int max_cache_size=0>
 class AddrRangeMap
@@ -78,12 +88,19 @@ class AddrRangeMap
     const_iterator
     contains(const AddrRange &r) const
     {
+        if (!r.interleaved() && useIndex()) {
+            const_iterator i = lookupIndex(r.start());
+            return i != end() && r.isSubset(i->first) ? i : end();
+        }
         return find(r, [r](const AddrRange r1) { return r.isSubset(r1); });
     }
     iterator
     contains(const AddrRange &r)
     {
-        return find(r, [r](const AddrRange r1) { return r.isSubset(r1); });
+        const_iterator i =
+            static_cast<const AddrRangeMap *>(this)->contains(r);
+        // Erasing an empty range turns the result back into an iterator
+        return tree.erase(i, i);
     }
 
     /**
@@ -134,12 +151,14 @@ class AddrRangeMap
         if (intersects(r) != end())
             return tree.end();
 
+        invalidateIndex();
         return tree.insert(std::make_pair(r, d)).first;
     }
 
     void
     erase(iterator p)
     {
+        invalidateIndex();
         cache.remove(p);
         tree.erase(p);
     }
@@ -147,8 +166,9 @@ class AddrRangeMap
     void
     erase(iterator p, iterator q)
     {
+        invalidateIndex();
         for (auto it = p; it != q; it++) {
-            cache.remove(p);
+            cache.remove(it);
         }
         tree.erase(p,q);
     }
@@ -156,6 +176,7 @@ class AddrRangeMap
     void
     clear()
     {
+        invalidateIndex();
         cache.erase(cache.begin(), cache.end());
         tree.erase(tree.begin(), tree.end());
     }
@@ -197,6 +218,103 @@ class AddrRangeMap
     }
 
   private:
+    /**
+     * Drop the compiled lookup array, called whenever the map changes.
+     */
+    void
+    invalidateIndex()
+    {
+        indexBuilt = false;
+        lookupsSinceChange = 0;
+    }
+
+    /**
+     * Check if lookups can use the compiled array, building it first if
+     * the map has been read often enough since it last changed.
+     *
+     * @return True if the compiled array is up to date and usable
+     */
+    bool
+    useIndex() const
+    {
+        if (indexBuilt)
+            return indexUsable;
+        if (++lookupsSinceChange < tree.size())
+            return false;
+        buildIndex();
+        return indexUsable;
+    }
+
+    /**
+     * Compile the map into the lookup array. Consecutive ranges that
+     * merge with each other, i.e. interleaved ranges over the same
+     * span, are grouped in a single slot. The array is only usable if
+     * the slots do not overlap, which is always the case unless
+     * differently interleaved ranges are mixed over the same addresses.
+     */
+    void
+    buildIndex() const
+    {
+        slotStarts.clear();
+        slotEnds.clear();
+        slotFirst.clear();
+        members.clear();
+        indexBuilt = true;
+        indexUsable = true;
+
+        for (auto it = tree.begin(); it != tree.end(); ++it) {
+            const AddrRange &r = it->first;
+            if (!members.empty() && r.mergesWith(members.back()->first)) {
+                members.push_back(it);
+                continue;
+            }
+            if (!slotEnds.empty() && r.start() < slotEnds.back())
+                indexUsable = false;
+            slotStarts.push_back(r.start());
+            slotEnds.push_back(r.end());
+            slotFirst.push_back(members.size());
+            members.push_back(it);
+        }
+        slotFirst.push_back(members.size());
+    }
+
+    /**
+     * Find the entry that contains an address using the compiled array.
+     *
+     * @param a An input address
+     * @return An iterator to the entry that contains the address
+     */
+    const_iterator
+    lookupIndex(Addr a) const
+    {
+        std::size_t n = slotStarts.size();
+        if (n == 0)
+            return tree.end();
+
+        // Find the last slot starting at or below the address, the
+        // select in the loop is compiled into a conditional move.
+        const Addr *base = slotStarts.data();
+        while (n > 1) {
+            const std::size_t half = n / 2;
+            base = base[half] <= a ? base + half : base;
+            n -= half;
+        }
+        const std::size_t slot = base - slotStarts.data();
+        if (*base > a || a >= slotEnds[slot])
+            return tree.end();
+
+        const std::size_t first = slotFirst[slot];
+        const std::size_t last = slotFirst[slot + 1];
+        if (last - first == 1)
+            return members[first];
+        // Interleaved slot, pick the member the address maps to
+        for (std::size_t m = first; m < last; m++) {
+            if (members[m]->first.contains(a))
+                return members[m];
+        }
+        return tree.end();
+    }
+
     /**
      * Add an address range map entry to the cache.
      *
@@ -285,6 +403,21 @@ class AddrRangeMap
      * always be valid iterators of the tree.
      */
     mutable std::list<iterator> cache;
+
+    /** Lookups done since the map last changed. */
+    mutable std::size_t lookupsSinceChange = 0;
+    mutable bool indexBuilt = false;
+    mutable bool indexUsable = false;
+
+    /**
+     * The compiled lookup array: the start and end addresses of each
+     * slot, and the index in members of its first entry. slotFirst has
+     * an extra element marking the end of the last slot.
+     */
+    mutable std::vector<Addr> slotStarts;
+    mutable std::vector<Addr> slotEnds;
+    mutable std::vector<std::size_t> slotFirst;
+    mutable std::vector<const_iterator> members;
 };
 
 #endif //__BASE_ADDR_RANGE_MAP_HH__
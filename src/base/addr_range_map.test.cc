@@ -66,3 +66,83 @@ TEST(AddrRangeMapTest, LegacyTests)
 
     EXPECT_NE(r.contains(RangeIn(20, 30)), r.end());
 }
+
+/**
+ * Check the compiled lookup array against the ranges themselves, on a map
+ * that looks like the memory map of a small SoC: a few device windows and
+ * DRAM interleaved over four channels at a 256 byte granularity.
+ */
+TEST(AddrRangeMapTest, CompiledLookups)
+{
+    AddrRangeMap<int> r;
+    std::vector<AddrRange> ranges = {
+        RangeSize(0x00000000, 0x4000000),  // boot ROM
+        RangeSize(0x1c010000, 0x1000),     // UART
+        RangeSize(0x1c020000, 0x1000),     // timer
+        RangeSize(0x2c000000, 0x10000),    // interrupt controller
+        RangeSize(0x40000000, 0x20000000), // PCI memory
+    };
+    for (int i = 0; i < 4; i++) {
+        ranges.push_back(AddrRange(0x80000000, 0x100000000, 9, 0, 2, i));
+    }
+    for (int i = 0; i < ranges.size(); i++) {
+        ASSERT_NE(r.insert(ranges[i], i), r.end());
+    }
+
+    std::vector<Addr> addrs;
+    for (const auto &range : ranges) {
+        addrs.push_back(range.start());
+        addrs.push_back(range.end() - 1);
+        addrs.push_back(range.end());
+        addrs.push_back(range.start() - 1);
+    }
+    for (Addr a = 0x7fffff00; a < 0x80001000; a += 0x40) {
+        addrs.push_back(a);
+    }
+
+    // Go around enough times for the map to compile itself
+    for (int pass = 0; pass < 3; pass++) {
+        for (Addr a : addrs) {
+            int expected = -1;
+            for (int i = 0; i < ranges.size(); i++) {
+                if (ranges[i].contains(a))
+                    expected = i;
+            }
+            auto i = r.contains(a);
+            if (expected < 0) {
+                EXPECT_EQ(i, r.end()) << std::hex << a;
+            } else {
+                ASSERT_NE(i, r.end()) << std::hex << a;
+                EXPECT_EQ(i->second, expected) << std::hex << a;
+            }
+        }
+    }
+
+    // A request straddling two ranges is not contained in either
+    EXPECT_EQ(r.contains(RangeSize(0x1c010ff0, 0x20)), r.end());
+    EXPECT_NE(r.contains(RangeSize(0x1c010ff0, 0x10)), r.end());
+}
+
+TEST(AddrRangeMapTest, CompiledLookupsAfterChange)
+{
+    AddrRangeMap<int> r;
+    ASSERT_NE(r.insert(RangeSize(0x1000, 0x1000), 1), r.end());
+    ASSERT_NE(r.insert(RangeSize(0x3000, 0x1000), 2), r.end());
+
+    for (int i = 0; i < 10; i++) {
+        ASSERT_NE(r.contains(0x3800), r.end());
+        EXPECT_EQ(r.contains(0x3800)->second, 2);
+    }
+
+    r.erase(r.contains(0x3800));
+    EXPECT_EQ(r.contains(0x3800), r.end());
+    ASSERT_NE(r.insert(RangeSize(0x2000, 0x2000), 3), r.end());
+    for (int i = 0; i < 10; i++) {
+        ASSERT_NE(r.contains(0x3800), r.end());
+        EXPECT_EQ(r.contains(0x3800)->second, 3);
+        EXPECT_EQ(r.contains(0x800), r.end());
+    }
+
+    r.clear();
+    EXPECT_EQ(r.contains(0x1800), r.end());
+}
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/kmeans.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+KMeans::KMeans(unsigned _dims, uint64_t seed, unsigned max_iters)
+    : dims(_dims), maxIters(max_iters), rng(seed), _numPoints(0),
+      _numClusters(0)
+{
+    assert(dims > 0);
+}
+
+void
+KMeans::addPoint(const double *point)
+{
+    points.insert(points.end(), point, point + dims);
+    _numPoints++;
+}
+
+double
+KMeans::distance(size_t point, unsigned c) const
+{
+    const double *p = &points[point * dims];
+    const double *q = &centroids[c * dims];
+    double dist = 0;
+    for (unsigned d = 0; d < dims; d++)
+        dist += (p[d] - q[d]) * (p[d] - q[d]);
+    return dist;
+}
+
+void
+KMeans::seedCentroids(unsigned k)
+{
+    centroids.clear();
+    _numClusters = 0;
+
+    // The first centroid is uniformly chosen, the following ones with a
+    // probability proportional to their squared distance to the closest
+    // centroid picked so far
+    std::vector<double> closest(_numPoints,
+                                std::numeric_limits<double>::max());
+    size_t pick = std::uniform_int_distribution<size_t>(
+        0, _numPoints - 1)(rng);
+    while (true) {
+        centroids.insert(centroids.end(), &points[pick * dims],
+                         &points[(pick + 1) * dims]);
+        _numClusters++;
+        if (_numClusters == k)
+            break;
+
+        double total = 0;
+        for (size_t i = 0; i < _numPoints; i++) {
+            closest[i] = std::min(closest[i],
+                                  distance(i, _numClusters - 1));
+            total += closest[i];
+        }
+        // Fewer distinct points than clusters
+        if (total == 0)
+            break;
+
+        double target =
+            std::uniform_real_distribution<double>(0, total)(rng);
+        for (pick = 0; pick < _numPoints - 1; pick++) {
+            target -= closest[pick];
+            if (target < 0)
+                break;
+        }
+    }
+}
+
+void
+KMeans::iterate()
+{
+    assignment.assign(_numPoints, 0);
+    sizes.assign(_numClusters, 0);
+
+    for (unsigned iter = 0; iter < maxIters; iter++) {
+        bool changed = false;
+        std::fill(sizes.begin(), sizes.end(), 0);
+        for (size_t i = 0; i < _numPoints; i++) {
+            unsigned best = 0;
+            double best_dist = distance(i, 0);
+            for (unsigned c = 1; c < _numClusters; c++) {
+                const double dist = distance(i, c);
+                if (dist < best_dist) {
+                    best = c;
+                    best_dist = dist;
+                }
+            }
+            changed |= iter == 0 || assignment[i] != best;
+            assignment[i] = best;
+            sizes[best]++;
+        }
+        if (!changed)
+            break;
+
+        // Move every centroid to the mean of its points, an empty
+        // cluster keeps its centroid
+        std::vector<double> sums(_numClusters * dims, 0.0);
+        for (size_t i = 0; i < _numPoints; i++) {
+            double *sum = &sums[assignment[i] * dims];
+            const double *p = &points[i * dims];
+            for (unsigned d = 0; d < dims; d++)
+                sum[d] += p[d];
+        }
+        for (unsigned c = 0; c < _numClusters; c++) {
+            if (!sizes[c])
+                continue;
+            for (unsigned d = 0; d < dims; d++)
+                centroids[c * dims + d] = sums[c * dims + d] / sizes[c];
+        }
+    }
+}
+
+void
+KMeans::dropEmpty()
+{
+    std::vector<unsigned> renumber(_numClusters);
+    unsigned kept = 0;
+    for (unsigned c = 0; c < _numClusters; c++) {
+        renumber[c] = kept;
+        if (!sizes[c])
+            continue;
+        std::copy(&centroids[c * dims], &centroids[(c + 1) * dims],
+                  &centroids[kept * dims]);
+        sizes[kept] = sizes[c];
+        kept++;
+    }
+    for (auto &c : assignment)
+        c = renumber[c];
+    _numClusters = kept;
+    centroids.resize(kept * dims);
+    sizes.resize(kept);
+}
+
+void
+KMeans::cluster(unsigned k)
+{
+    assert(k > 0);
+    assert(_numPoints > 0);
+
+    seedCentroids(std::min<size_t>(k, _numPoints));
+    iterate();
+    dropEmpty();
+}
+
+void
+KMeans::clusterBest(unsigned max_k, double threshold)
+{
+    assert(max_k > 0);
+
+    struct Clustering
+    {
+        unsigned numClusters;
+        std::vector<double> centroids;
+        std::vector<unsigned> assignment;
+        std::vector<size_t> sizes;
+        double bic;
+    };
+
+    std::vector<Clustering> tried;
+    for (unsigned k = 1; k <= std::min<size_t>(max_k, _numPoints); k++) {
+        cluster(k);
+        tried.push_back(Clustering{_numClusters, centroids, assignment,
+                                   sizes, bic()});
+    }
+
+    double min_bic = std::numeric_limits<double>::max();
+    double max_bic = std::numeric_limits<double>::lowest();
+    for (const auto &c : tried) {
+        min_bic = std::min(min_bic, c.bic);
+        max_bic = std::max(max_bic, c.bic);
+    }
+    const double target = min_bic + threshold * (max_bic - min_bic);
+
+    for (auto &c : tried) {
+        if (c.bic >= target) {
+            _numClusters = c.numClusters;
+            centroids.swap(c.centroids);
+            assignment.swap(c.assignment);
+            sizes.swap(c.sizes);
+            return;
+        }
+    }
+}
+
+size_t
+KMeans::representative(unsigned c) const
+{
+    assert(c < _numClusters);
+    size_t best = 0;
+    double best_dist = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < _numPoints; i++) {
+        if (assignment[i] != c)
+            continue;
+        const double dist = distance(i, c);
+        if (dist < best_dist) {
+            best = i;
+            best_dist = dist;
+        }
+    }
+    return best;
+}
+
+double
+KMeans::bic() const
+{
+    // Score of a mixture of spherical Gaussians with a shared variance,
+    // as in X-means (Pelleg and Moore) and SimPoint
+    const double r = _numPoints;
+    const double k = _numClusters;
+    const double m = dims;
+
+    double distortion = 0;
+    for (size_t i = 0; i < _numPoints; i++)
+        distortion += distance(i, assignment[i]);
+
+    // Maximum likelihood estimate of the variance per dimension, kept
+    // away from zero for perfectly fitting clusterings
+    double variance = r > k ? distortion / (m * (r - k)) : 0;
+    variance = std::max(variance, std::numeric_limits<double>::min());
+
+    double likelihood = -m * (r - k) / 2;
+    for (unsigned c = 0; c < _numClusters; c++) {
+        const double rn = sizes[c];
+        likelihood += rn * std::log(rn) - rn * std::log(r) -
+            rn * m / 2 * std::log(2 * M_PI * variance);
+    }
+
+    const double params = (k - 1) + m * k + 1;
+    return likelihood - params / 2 * std::log(r);
+}
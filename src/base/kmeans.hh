@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_KMEANS_HH__
+#define __BASE_KMEANS_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/**
+ * K-means clustering of points in a low-dimensional space, as used to
+ * pick SimPoints from projected basic block vectors.
+ *
+ * Clustering starts from a k-means++ seeding and runs Lloyd iterations
+ * until the assignment is stable. The number of clusters can either be
+ * given, or picked as SimPoint does: every k up to a maximum is tried,
+ * and the smallest k whose Bayesian Information Criterion (BIC) score
+ * reaches a fraction of the range of scores seen is kept. Clusters that
+ * end up empty are dropped, so all reported clusters have members.
+ *
+ * The generator is seeded explicitly, so the result only depends on the
+ * points and the seed.
+ */
+class KMeans
+{
+  public:
+    /**
+     * @param dims Number of coordinates of every point.
+     * @param seed Seed of the generator used for the initial centroids.
+     * @param max_iters Maximum number of Lloyd iterations per clustering.
+     */
+    KMeans(unsigned dims, uint64_t seed, unsigned max_iters = 100);
+
+    /**
+     * Add a point to be clustered.
+     *
+     * @param point Pointer to the dims coordinates of the point.
+     */
+    void addPoint(const double *point);
+
+    size_t numPoints() const { return _numPoints; }
+
+    /**
+     * Cluster the points in (at most) k clusters.
+     *
+     * @param k Number of clusters, at least 1.
+     */
+    void cluster(unsigned k);
+
+    /**
+     * Cluster the points trying all k from 1 to max_k, and keep the
+     * smallest k whose BIC score is at least min + threshold * (max -
+     * min) over all the scores.
+     *
+     * @param max_k Largest number of clusters to try.
+     * @param threshold Fraction of the BIC range to reach.
+     */
+    void clusterBest(unsigned max_k, double threshold = 0.9);
+
+    unsigned numClusters() const { return _numClusters; }
+
+    /** Cluster of a point. */
+    unsigned clusterOf(size_t point) const { return assignment[point]; }
+
+    /** Number of points in a cluster. */
+    size_t clusterSize(unsigned c) const { return sizes[c]; }
+
+    /** Point closest to the centroid of a cluster. */
+    size_t representative(unsigned c) const;
+
+    /** BIC score of the current clustering. */
+    double bic() const;
+
+  private:
+    /** Squared distance between a point and a centroid. */
+    double distance(size_t point, unsigned c) const;
+
+    /** Pick the initial centroids with k-means++. */
+    void seedCentroids(unsigned k);
+
+    /** Run Lloyd iterations from the current centroids. */
+    void iterate();
+
+    /** Remove empty clusters and renumber the others. */
+    void dropEmpty();
+
+    const unsigned dims;
+    const unsigned maxIters;
+    std::mt19937_64 rng;
+
+    /** Coordinates of all points, dims values each. */
+    std::vector<double> points;
+    size_t _numPoints;
+
+    unsigned _numClusters;
+    /** Coordinates of the centroids, dims values each. */
+    std::vector<double> centroids;
+    std::vector<unsigned> assignment;
+    std::vector<size_t> sizes;
+};
+
+#endif // __BASE_KMEANS_HH__
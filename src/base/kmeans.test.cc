@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <set>
+
+#include "base/kmeans.hh"
+
+namespace
+{
+
+/**
+ * Add n points drawn around each of the given 2D centers.
+ */
+void
+addBlobs(KMeans &kmeans,
+         const std::vector<std::pair<double, double>> &centers,
+         unsigned n)
+{
+    std::mt19937_64 gen(1);
+    std::normal_distribution<double> noise(0, 0.05);
+    for (unsigned i = 0; i < n; i++) {
+        for (const auto &center : centers) {
+            const double point[2] = { center.first + noise(gen),
+                                      center.second + noise(gen) };
+            kmeans.addPoint(point);
+        }
+    }
+}
+
+} // anonymous namespace
+
+/**
+ * Test that well separated groups end up in clusters of their own.
+ */
+TEST(KMeansTest, SeparatedGroups)
+{
+    KMeans kmeans(2, 7);
+    addBlobs(kmeans, {{0, 0}, {5, 0}, {0, 5}}, 50);
+    kmeans.cluster(3);
+
+    ASSERT_EQ(kmeans.numClusters(), 3u);
+    std::set<unsigned> seen;
+    for (size_t group = 0; group < 3; group++) {
+        // Points were added round-robin over the groups
+        const unsigned c = kmeans.clusterOf(group);
+        for (size_t i = group; i < kmeans.numPoints(); i += 3)
+            ASSERT_EQ(kmeans.clusterOf(i), c);
+        ASSERT_EQ(kmeans.clusterSize(c), 50u);
+        ASSERT_EQ(kmeans.representative(c) % 3, group);
+        seen.insert(c);
+    }
+    ASSERT_EQ(seen.size(), 3u);
+}
+
+/**
+ * Test that the BIC search picks the number of groups in the data.
+ */
+TEST(KMeansTest, BestNumberOfClusters)
+{
+    KMeans kmeans(2, 3);
+    addBlobs(kmeans, {{0, 0}, {4, 4}, {8, 0}, {4, -4}}, 40);
+    kmeans.clusterBest(10);
+
+    ASSERT_EQ(kmeans.numClusters(), 4u);
+}
+
+/**
+ * Test that asking for more clusters than distinct points only keeps
+ * non-empty clusters.
+ */
+TEST(KMeansTest, FewerPointsThanClusters)
+{
+    KMeans kmeans(1, 1);
+    const double a = 1.0, b = 2.0;
+    for (int i = 0; i < 3; i++) {
+        kmeans.addPoint(&a);
+        kmeans.addPoint(&b);
+    }
+    kmeans.cluster(5);
+
+    ASSERT_EQ(kmeans.numClusters(), 2u);
+    ASSERT_EQ(kmeans.clusterSize(0) + kmeans.clusterSize(1), 6u);
+    ASSERT_NE(kmeans.clusterOf(0), kmeans.clusterOf(1));
+}
+
+/**
+ * Test that the clustering only depends on the points and the seed.
+ */
+TEST(KMeansTest, Deterministic)
+{
+    KMeans first(2, 11), second(2, 11);
+    addBlobs(first, {{0, 0}, {1, 1}, {2, 0}}, 30);
+    addBlobs(second, {{0, 0}, {1, 1}, {2, 0}}, 30);
+    first.clusterBest(6);
+    second.clusterBest(6);
+
+    ASSERT_EQ(first.numClusters(), second.numClusters());
+    for (size_t i = 0; i < first.numPoints(); i++)
+        ASSERT_EQ(first.clusterOf(i), second.clusterOf(i));
+}
@@ -0,0 +1,59 @@
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.SimObject import SimObject
+
+# Drives SMARTS-style sampled simulation: every period instructions, a
+# sample of length instructions is measured on the detailed CPUs after
+# warmup instructions of detailed warm-up, and the rest of the period
+# runs on the functional CPUs. The CPU switches themselves are done by
+# the configuration script, see sampledSimulation() in
+# configs/common/Simulation.py.
+class SamplingController(SimObject):
+    type = 'SamplingController'
+    cxx_header = "cpu/sampling_controller.hh"
+
+    functional_cpus = VectorParam.BaseCPU("CPUs running between samples")
+    detailed_cpus = VectorParam.BaseCPU("CPUs the samples are measured on")
+
+    period = Param.Counter(1000000, "Instructions between the starts of "
+        "consecutive samples")
+    warmup = Param.Counter(2000, "Instructions of detailed warm-up before "
+        "every sample")
+    length = Param.Counter(1000, "Instructions measured per sample")
+
+    confidence_z = Param.Float(3.0, "Z-score of the confidence interval, "
+        "3.0 for 99.7%")
+    target_error = Param.Float(0.0, "Stop once the confidence interval of "
+        "the CPI is within this fraction of it, 0 to run to completion")
+    min_samples = Param.Unsigned(30, "Samples needed before stopping on "
+        "the target error")
+    max_samples = Param.Unsigned(0, "Stop after this many samples, 0 for "
+        "no limit")
+
+    sample_file = Param.String("samples.txt", "Per-sample output file, "
+        "empty to disable")
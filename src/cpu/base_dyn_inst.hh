@@ -88,8 +88,8 @@ class BaseDynInst : public ExecContext, public RefCounted
     typedef typename Impl::DynInstPtr DynInstPtr;
     typedef RefCountingPtr<BaseDynInst<Impl> > BaseDynInstPtr;
 
-    // The list of instructions iterator type.
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
+    // The position of an instruction in the CPU's list of instructions.
+    typedef uint64_t ListIt;
 
     enum {
         MaxInstSrcRegs = TheISA::MaxInstSrcRegs,        /// Max source regs
@@ -190,7 +190,7 @@ class BaseDynInst : public ExecContext, public RefCounted
     /** The thread this instruction is from. */
     ThreadID threadNumber;
 
-    /** Iterator pointing to this BaseDynInst in the list of all insts. */
+    /** Position of this BaseDynInst in the list of all insts. */
     ListIt instListIt;
 
     ////////////////////// Branch Data ///////////////
@@ -924,10 +924,10 @@ class BaseDynInst : public ExecContext, public RefCounted
     /** Assert this instruction has generated a memory request. */
     void setRequest() { instFlags[ReqMade] = true; }
 
-    /** Returns iterator to this instruction in the list of all insts. */
+    /** Returns the position of this instruction in the list of all insts. */
     ListIt &getInstListIt() { return instListIt; }
 
-    /** Sets iterator for this instruction in the list of all insts. */
+    /** Sets the position of this instruction in the list of all insts. */
     void setInstListIt(ListIt _instListIt) { instListIt = _instListIt; }
 
   public:
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_AGE_MATRIX_HH__
+#define __CPU_O3_AGE_MATRIX_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "base/bitfield.hh"
+#include "base/types.hh"
+
+/**
+ * Set of items held in numbered slots, each with an age and a group, that
+ * selects its oldest item with bit operations. It is the age matrix of
+ * hardware schedulers: every slot has a row with a bit set for each slot
+ * holding an older item. The oldest item among a set of candidates is the
+ * one whose row has no candidate in it.
+ *
+ * The O3 IQ keeps its ready instructions in one, grouped by op class, and
+ * blocks the op classes whose FUs are busy for the rest of the cycle.
+ * Items of equal age are ordered by insertion.
+ *
+ * The number of slots is set by init(), and doubles if an item is pushed
+ * while all the slots are taken.
+ */
+template <class T>
+class AgeMatrix
+{
+  public:
+    AgeMatrix()
+        : numSlots(0), words(0), numItems(0)
+    { }
+
+    /**
+     * Set the number of groups and the initial number of slots. Must be
+     * called before use.
+     */
+    void init(int num_groups, int num_slots);
+
+    /** Remove every item. */
+    void clear();
+
+    /** Whether there are no items. */
+    bool empty() const { return numItems == 0; }
+
+    /** Number of items of a group. */
+    int size(int group) const { return groupSize[group]; }
+
+    /**
+     * Add an item.
+     * @return The slot holding it.
+     */
+    int push(const T &item, uint64_t age, int group);
+
+    /** Remove the item of a slot. */
+    void erase(int slot);
+
+    /** The item of a slot. */
+    const T &item(int slot) const { return items[slot]; }
+
+    /** The group of the item of a slot. */
+    int group(int slot) const { return groups[slot]; }
+
+    /**
+     * Find the oldest item that is not in a blocked group.
+     * @return Its slot, or -1 if there is none.
+     */
+    int oldest() const;
+
+    /** Leave the items of a group, including later ones, out of oldest(). */
+    void block(int group);
+
+    /** Let oldest() pick from every group again. */
+    void unblockAll();
+
+  private:
+    /** Double the number of slots. */
+    void grow();
+
+    /** Row of a slot: the bits of the slots holding older items. */
+    uint64_t *row(int slot) { return &older[slot * words]; }
+    const uint64_t *row(int slot) const { return &older[slot * words]; }
+
+    /** Whether an item is not in a blocked group, for a word of slots. */
+    uint64_t
+    candidates(int word) const
+    {
+        return valid[word] & ~blocked[word];
+    }
+
+    int numSlots;
+
+    /** Number of 64-bit words in a row. */
+    int words;
+
+    int numItems;
+
+    std::vector<T> items;
+    std::vector<uint64_t> ages;
+    std::vector<int> groups;
+
+    std::vector<int> groupSize;
+    std::vector<bool> groupBlocked;
+
+    /** Bitmap of the slots holding an item. */
+    std::vector<uint64_t> valid;
+
+    /** Bitmap of the slots holding an item of a blocked group. */
+    std::vector<uint64_t> blocked;
+
+    /** The rows of all the slots. Rows of empty slots are meaningless. */
+    std::vector<uint64_t> older;
+};
+
+template <class T>
+void
+AgeMatrix<T>::init(int num_groups, int num_slots)
+{
+    assert(num_slots > 0);
+
+    groupSize.assign(num_groups, 0);
+    groupBlocked.assign(num_groups, false);
+
+    numSlots = 0;
+    words = 0;
+    items.clear();
+    ages.clear();
+    groups.clear();
+    valid.clear();
+    blocked.clear();
+    older.clear();
+
+    while (numSlots < num_slots) {
+        grow();
+    }
+    numItems = 0;
+}
+
+template <class T>
+void
+AgeMatrix<T>::clear()
+{
+    for (int slot = 0; slot < numSlots; slot++) {
+        items[slot] = T();
+    }
+    std::fill(valid.begin(), valid.end(), 0);
+    std::fill(blocked.begin(), blocked.end(), 0);
+    std::fill(groupSize.begin(), groupSize.end(), 0);
+    std::fill(groupBlocked.begin(), groupBlocked.end(), false);
+    numItems = 0;
+}
+
+template <class T>
+void
+AgeMatrix<T>::grow()
+{
+    const int new_slots = numSlots ? 2 * numSlots : 64;
+    const int new_words = (new_slots + 63) / 64;
+
+    std::vector<uint64_t> new_older(new_slots * new_words, 0);
+    for (int slot = 0; slot < numSlots; slot++) {
+        std::copy(row(slot), row(slot) + words,
+                  &new_older[slot * new_words]);
+    }
+    older.swap(new_older);
+
+    items.resize(new_slots);
+    ages.resize(new_slots);
+    groups.resize(new_slots);
+    valid.resize(new_words, 0);
+    blocked.resize(new_words, 0);
+
+    numSlots = new_slots;
+    words = new_words;
+}
+
+template <class T>
+int
+AgeMatrix<T>::push(const T &item, uint64_t age, int group)
+{
+    if (numItems == numSlots) {
+        grow();
+    }
+
+    // Slots are a multiple of 64, so a free slot is a clear bit of valid
+    int slot = -1;
+    for (int w = 0; slot < 0; w++) {
+        assert(w < words);
+        if (~valid[w]) {
+            slot = w * 64 + findLsbSet(~valid[w]);
+        }
+    }
+
+    const int slot_word = slot / 64;
+    const uint64_t slot_bit = ULL(1) << (slot % 64);
+
+    // Fill in the row of the new item, and its column in the rows of the
+    // items already there
+    uint64_t *slot_row = row(slot);
+    for (int w = 0; w < words; w++) {
+        slot_row[w] = 0;
+        for (uint64_t others = valid[w]; others; others &= others - 1) {
+            const int other = w * 64 + findLsbSet(others);
+            if (ages[other] <= age) {
+                slot_row[w] |= ULL(1) << (other % 64);
+                row(other)[slot_word] &= ~slot_bit;
+            } else {
+                row(other)[slot_word] |= slot_bit;
+            }
+        }
+    }
+
+    items[slot] = item;
+    ages[slot] = age;
+    groups[slot] = group;
+    valid[slot_word] |= slot_bit;
+    if (groupBlocked[group]) {
+        blocked[slot_word] |= slot_bit;
+    }
+    groupSize[group]++;
+    numItems++;
+
+    return slot;
+}
+
+template <class T>
+void
+AgeMatrix<T>::erase(int slot)
+{
+    const uint64_t slot_bit = ULL(1) << (slot % 64);
+
+    assert(valid[slot / 64] & slot_bit);
+    valid[slot / 64] &= ~slot_bit;
+    blocked[slot / 64] &= ~slot_bit;
+    items[slot] = T();
+    groupSize[groups[slot]]--;
+    numItems--;
+}
+
+template <class T>
+int
+AgeMatrix<T>::oldest() const
+{
+    for (int w = 0; w < words; w++) {
+        for (uint64_t cands = candidates(w); cands; cands &= cands - 1) {
+            const int slot = w * 64 + findLsbSet(cands);
+            const uint64_t *slot_row = row(slot);
+
+            bool is_oldest = true;
+            for (int v = 0; v < words && is_oldest; v++) {
+                is_oldest = !(slot_row[v] & candidates(v));
+            }
+            if (is_oldest) {
+                return slot;
+            }
+        }
+    }
+    return -1;
+}
+
+template <class T>
+void
+AgeMatrix<T>::block(int group)
+{
+    if (groupBlocked[group]) {
+        return;
+    }
+    groupBlocked[group] = true;
+
+    for (int w = 0; w < words; w++) {
+        for (uint64_t slots = valid[w]; slots; slots &= slots - 1) {
+            const int slot = w * 64 + findLsbSet(slots);
+            if (groups[slot] == group) {
+                blocked[w] |= ULL(1) << (slot % 64);
+            }
+        }
+    }
+}
+
+template <class T>
+void
+AgeMatrix<T>::unblockAll()
+{
+    std::fill(blocked.begin(), blocked.end(), 0);
+    std::fill(groupBlocked.begin(), groupBlocked.end(), false);
+}
+
+#endif // __CPU_O3_AGE_MATRIX_HH__
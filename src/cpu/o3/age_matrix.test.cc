@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+
+#include "cpu/o3/age_matrix.hh"
+
+TEST(AgeMatrixTest, Empty)
+{
+    AgeMatrix<int> matrix;
+    matrix.init(4, 8);
+
+    EXPECT_TRUE(matrix.empty());
+    EXPECT_EQ(-1, matrix.oldest());
+}
+
+TEST(AgeMatrixTest, OldestFirst)
+{
+    AgeMatrix<int> matrix;
+    matrix.init(4, 8);
+
+    // Pushed out of age order
+    matrix.push(30, 30, 0);
+    matrix.push(10, 10, 1);
+    matrix.push(20, 20, 0);
+
+    EXPECT_FALSE(matrix.empty());
+    EXPECT_EQ(2, matrix.size(0));
+    EXPECT_EQ(1, matrix.size(1));
+
+    for (int expected : {10, 20, 30}) {
+        int slot = matrix.oldest();
+        ASSERT_GE(slot, 0);
+        EXPECT_EQ(expected, matrix.item(slot));
+        matrix.erase(slot);
+    }
+    EXPECT_TRUE(matrix.empty());
+    EXPECT_EQ(-1, matrix.oldest());
+}
+
+TEST(AgeMatrixTest, EqualAgesInInsertionOrder)
+{
+    AgeMatrix<int> matrix;
+    matrix.init(1, 8);
+
+    matrix.push(1, 5, 0);
+    matrix.push(2, 5, 0);
+    matrix.push(3, 5, 0);
+
+    for (int expected : {1, 2, 3}) {
+        int slot = matrix.oldest();
+        EXPECT_EQ(expected, matrix.item(slot));
+        matrix.erase(slot);
+    }
+}
+
+TEST(AgeMatrixTest, BlockedGroups)
+{
+    AgeMatrix<int> matrix;
+    matrix.init(3, 8);
+
+    matrix.push(1, 1, 0);
+    matrix.push(2, 2, 1);
+    matrix.push(3, 3, 2);
+
+    matrix.block(0);
+    EXPECT_EQ(2, matrix.item(matrix.oldest()));
+
+    // Later items of a blocked group are blocked as well
+    matrix.push(0, 0, 0);
+    EXPECT_EQ(2, matrix.item(matrix.oldest()));
+
+    matrix.block(1);
+    EXPECT_EQ(3, matrix.item(matrix.oldest()));
+
+    matrix.block(2);
+    EXPECT_EQ(-1, matrix.oldest());
+
+    matrix.unblockAll();
+    EXPECT_EQ(0, matrix.item(matrix.oldest()));
+}
+
+TEST(AgeMatrixTest, Grow)
+{
+    AgeMatrix<int> matrix;
+    matrix.init(1, 1);
+
+    // Youngest first, over several words of slots
+    for (int i = 200; i > 0; i--) {
+        matrix.push(i, i, 0);
+    }
+    for (int i = 1; i <= 200; i++) {
+        int slot = matrix.oldest();
+        ASSERT_GE(slot, 0);
+        EXPECT_EQ(i, matrix.item(slot));
+        matrix.erase(slot);
+    }
+    EXPECT_TRUE(matrix.empty());
+}
+
+TEST(AgeMatrixTest, Clear)
+{
+    AgeMatrix<int> matrix;
+    matrix.init(2, 8);
+
+    matrix.push(1, 1, 0);
+    matrix.push(2, 2, 1);
+    matrix.block(0);
+    matrix.clear();
+
+    EXPECT_TRUE(matrix.empty());
+    EXPECT_EQ(0, matrix.size(0));
+    EXPECT_EQ(-1, matrix.oldest());
+
+    // Blocking does not outlive a clear
+    matrix.push(3, 3, 0);
+    EXPECT_EQ(3, matrix.item(matrix.oldest()));
+}
+
+/**
+ * Pick items as the IQ does, from a random mix of pushes, picks and
+ * blocked groups, and compare every pick with a set sorted by age.
+ */
+TEST(AgeMatrixTest, MatchesSortedSet)
+{
+    const int num_groups = 8;
+    std::mt19937 rng(1);
+
+    AgeMatrix<int> matrix;
+    matrix.init(num_groups, 64);
+
+    // Items of the reference, by age then insertion order
+    std::set<std::pair<uint64_t, int>> reference;
+    std::map<int, int> reference_groups;
+    std::set<int> blocked_groups;
+    int next_item = 0;
+
+    for (int n = 0; n < 100000; n++) {
+        switch (rng() % 8) {
+          case 0:
+          case 1:
+          case 2:
+            {
+                // Ages are close together so that some are equal
+                const uint64_t age = n / 2 + rng() % 64;
+                const int group = rng() % num_groups;
+                matrix.push(next_item, age, group);
+                reference.emplace(age, next_item);
+                reference_groups[next_item] = group;
+                next_item++;
+            }
+            break;
+          case 3:
+          case 4:
+          case 5:
+          case 6:
+            {
+                int slot = matrix.oldest();
+                auto it = reference.begin();
+                while (it != reference.end() &&
+                       blocked_groups.count(reference_groups[it->second])) {
+                    ++it;
+                }
+                if (it == reference.end()) {
+                    ASSERT_EQ(-1, slot);
+                    break;
+                }
+                ASSERT_GE(slot, 0);
+                ASSERT_EQ(it->second, matrix.item(slot));
+                ASSERT_EQ(reference_groups[it->second], matrix.group(slot));
+                if (rng() % 4) {
+                    matrix.erase(slot);
+                    reference.erase(it);
+                } else {
+                    matrix.block(matrix.group(slot));
+                    blocked_groups.insert(matrix.group(slot));
+                }
+            }
+            break;
+          default:
+            matrix.unblockAll();
+            blocked_groups.clear();
+        }
+    }
+}
@@ -744,7 +744,7 @@ DefaultCommit<Impl>::handleInterrupt()
 
     // Wait until all in flight instructions are finished before enterring
     // the interrupt.
-    if (canHandleInterrupts && cpu->instList.empty()) {
+    if (canHandleInterrupts && cpu->instListEmpty()) {
         // Squash or record that I need to squash this cycle if
         // an interrupt needed to be handled.
         DPRINTF(Commit, "Interrupt detected.\n");
@@ -778,7 +778,7 @@ DefaultCommit<Impl>::handleInterrupt()
         DPRINTF(Commit, "Interrupt pending: instruction is %sin "
                 "flight, ROB is %sempty\n",
                 canHandleInterrupts ? "not " : "",
-                cpu->instList.empty() ? "" : "not " );
+                cpu->instListEmpty() ? "" : "not " );
     }
 }
 
@@ -44,6 +44,7 @@
 
 #include "arch/generic/traits.hh"
 #include "arch/kernel_stats.hh"
+#include "base/intmath.hh"
 #include "config/the_isa.hh"
 #include "cpu/activity.hh"
 #include "cpu/checker/cpu.hh"
@@ -92,6 +93,8 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
 #ifndef NDEBUG
       instcount(0),
 #endif
+      instListHead(0),
+      instListTail(0),
       removeInstsThisCycle(false),
       fetch(this, params),
       decode(this, params),
@@ -151,6 +154,10 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
         tids.resize(numThreads);
     }
 
+    // Room for the instructions in the ROB and as many on their way to
+    // it; the list grows if more are in flight.
+    instList.resize(ULL(1) << ceilLog2(2 * params->numROBEntries));
+
     // The stages also need their CPU pointer setup.  However this
     // must be done at the upper level CPU because they have pointers
     // to the upper level CPU, and not this FullO3CPU.
@@ -1051,7 +1058,7 @@ FullO3CPU<Impl>::isCpuDrained() const
 {
     bool drained(true);
 
-    if (!instList.empty() || !removeList.empty()) {
+    if (!instListEmpty() || !removeList.empty()) {
         DPRINTF(Drain, "Main CPU structures not drained.\n");
         drained = false;
     }
@@ -1508,9 +1515,17 @@ template <class Impl>
 typename FullO3CPU<Impl>::ListIt
 FullO3CPU<Impl>::addInst(const DynInstPtr &inst)
 {
-    instList.push_back(inst);
+    if (instListTail - instListHead == instList.size()) {
+        std::vector<DynInstPtr> ring(2 * instList.size());
+        for (ListIt pos = instListHead; pos != instListTail; pos++) {
+            ring[pos & (ring.size() - 1)] = std::move(instListAt(pos));
+        }
+        instList.swap(ring);
+    }
+
+    instListAt(instListTail) = inst;
 
-    return --(instList.end());
+    return instListTail++;
 }
 
 template <class Impl>
@@ -1559,11 +1574,11 @@ FullO3CPU<Impl>::removeInstsNotInROB(ThreadID tid)
 
     bool rob_empty = false;
 
-    if (instList.empty()) {
+    if (instListEmpty()) {
         return;
     } else if (rob.isEmpty(tid)) {
         DPRINTF(O3CPU, "ROB is empty, squashing all insts.\n");
-        end_it = instList.begin();
+        end_it = instListHead;
         rob_empty = true;
     } else {
         end_it = (rob.readTailInst(tid))->getInstListIt();
@@ -1572,14 +1587,14 @@ FullO3CPU<Impl>::removeInstsNotInROB(ThreadID tid)
 
     removeInstsThisCycle = true;
 
-    ListIt inst_it = instList.end();
+    ListIt inst_it = instListTail;
 
     inst_it--;
 
     // Walk through the instruction list, removing any instructions
-    // that were inserted after the given instruction iterator, end_it.
+    // that were inserted after the given instruction position, end_it.
     while (inst_it != end_it) {
-        assert(!instList.empty());
+        assert(!instListEmpty());
 
         squashInstIt(inst_it, tid);
 
@@ -1597,21 +1612,24 @@ template <class Impl>
 void
 FullO3CPU<Impl>::removeInstsUntil(const InstSeqNum &seq_num, ThreadID tid)
 {
-    assert(!instList.empty());
+    assert(!instListEmpty());
 
     removeInstsThisCycle = true;
 
-    ListIt inst_iter = instList.end();
+    ListIt inst_iter = instListTail;
 
     inst_iter--;
 
     DPRINTF(O3CPU, "Deleting instructions from instruction "
             "list that are from [tid:%i] and above [sn:%lli] (end=%lli).\n",
-            tid, seq_num, (*inst_iter)->seqNum);
+            tid, seq_num, instListAt(inst_iter)->seqNum);
 
-    while ((*inst_iter)->seqNum > seq_num) {
+    // Entries of instructions of other threads that already left are
+    // empty, and are walked over.
+    while (!instListAt(inst_iter) ||
+           instListAt(inst_iter)->seqNum > seq_num) {
 
-        bool break_loop = (inst_iter == instList.begin());
+        bool break_loop = (inst_iter == instListHead);
 
         squashInstIt(inst_iter, tid);
 
@@ -1626,19 +1644,19 @@ template <class Impl>
 inline void
 FullO3CPU<Impl>::squashInstIt(const ListIt &instIt, ThreadID tid)
 {
-    if ((*instIt)->threadNumber == tid) {
+    const DynInstPtr &inst = instListAt(instIt);
+
+    if (inst && inst->threadNumber == tid) {
         DPRINTF(O3CPU, "Squashing instruction, "
                 "[tid:%i] [sn:%lli] PC %s\n",
-                (*instIt)->threadNumber,
-                (*instIt)->seqNum,
-                (*instIt)->pcState());
+                inst->threadNumber,
+                inst->seqNum,
+                inst->pcState());
 
         // Mark it as squashed.
-        (*instIt)->setSquashed();
+        inst->setSquashed();
 
-        // @todo: Formulate a consistent method for deleting
-        // instructions from the instruction list
-        // Remove the instruction from the list.
+        // Remove the instruction from the list at the end of the cycle.
         removeList.push(instIt);
     }
 }
@@ -1648,17 +1666,30 @@ void
 FullO3CPU<Impl>::cleanUpRemovedInsts()
 {
     while (!removeList.empty()) {
-        DPRINTF(O3CPU, "Removing instruction, "
-                "[tid:%i] [sn:%lli] PC %s\n",
-                (*removeList.front())->threadNumber,
-                (*removeList.front())->seqNum,
-                (*removeList.front())->pcState());
+        DynInstPtr &inst = instListAt(removeList.front());
 
-        instList.erase(removeList.front());
+        if (inst) {
+            DPRINTF(O3CPU, "Removing instruction, "
+                    "[tid:%i] [sn:%lli] PC %s\n",
+                    inst->threadNumber,
+                    inst->seqNum,
+                    inst->pcState());
+
+            inst = nullptr;
+        }
 
         removeList.pop();
     }
 
+    // With a single thread, squashed instructions are the youngest ones
+    // and committed ones the oldest, so the list only shrinks at its ends.
+    while (!instListEmpty() && !instListAt(instListTail - 1)) {
+        instListTail--;
+    }
+    while (!instListEmpty() && !instListAt(instListHead)) {
+        instListHead++;
+    }
+
     removeInstsThisCycle = false;
 }
 /*
@@ -1675,17 +1706,18 @@ FullO3CPU<Impl>::dumpInsts()
 {
     int num = 0;
 
-    ListIt inst_list_it = instList.begin();
-
     cprintf("Dumping Instruction List\n");
 
-    while (inst_list_it != instList.end()) {
+    for (ListIt pos = instListHead; pos != instListTail; pos++) {
+        const DynInstPtr &inst = instListAt(pos);
+        if (!inst) {
+            continue;
+        }
         cprintf("Instruction:%i\nPC:%#x\n[tid:%i]\n[sn:%lli]\nIssued:%i\n"
                 "Squashed:%i\n\n",
-                num, (*inst_list_it)->instAddr(), (*inst_list_it)->threadNumber,
-                (*inst_list_it)->seqNum, (*inst_list_it)->isIssued(),
-                (*inst_list_it)->isSquashed());
-        inst_list_it++;
+                num, inst->instAddr(), inst->threadNumber,
+                inst->seqNum, inst->isIssued(),
+                inst->isSquashed());
         ++num;
     }
 }
@@ -107,7 +107,10 @@ class FullO3CPU : public BaseO3CPU
     typedef O3ThreadState<Impl> ImplState;
     typedef O3ThreadState<Impl> Thread;
 
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
+    /** Position of an instruction in the list of all instructions, counted
+     *  from the first instruction the CPU fetched.
+     */
+    typedef uint64_t ListIt;
 
     friend class O3ThreadContext<Impl>;
 
@@ -522,7 +525,7 @@ class FullO3CPU : public BaseO3CPU
     /** Remove all instructions younger than the given sequence number. */
     void removeInstsUntil(const InstSeqNum &seq_num, ThreadID tid);
 
-    /** Removes the instruction pointed to by the iterator. */
+    /** Removes the instruction at the given position. */
     inline void squashInstIt(const ListIt &instIt, ThreadID tid);
 
     /** Cleans up all instructions on the remove list. */
@@ -537,8 +540,32 @@ class FullO3CPU : public BaseO3CPU
     int instcount;
 #endif
 
-    /** List of all the instructions in flight. */
-    std::list<DynInstPtr> instList;
+    /** List of all the instructions in flight, oldest first, as a ring
+     *  indexed by their position.  The entries of removed instructions are
+     *  cleared at the end of the cycle, and the list shrinks past cleared
+     *  entries at both ends: committed instructions leave from the head
+     *  and squashed ones are truncated from the tail.  Only with SMT can
+     *  an instruction leave from the middle; its entry then stays until
+     *  the instructions before or after it are gone.  The ring holds a
+     *  power of two entries, and doubles when it is full.
+     */
+    std::vector<DynInstPtr> instList;
+
+    /** Position of the oldest instruction in the list. */
+    ListIt instListHead;
+
+    /** Position after the youngest instruction in the list. */
+    ListIt instListTail;
+
+    /** Entry of the list at the given position. */
+    DynInstPtr &
+    instListAt(ListIt pos)
+    {
+        return instList[pos & (instList.size() - 1)];
+    }
+
+    /** Whether there is no instruction in flight. */
+    bool instListEmpty() const { return instListHead == instListTail; }
 
     /** List of all the instructions that will be removed at the end of this
      *  cycle.
@@ -86,6 +86,16 @@ class BaseO3DynInst : public BaseDynInst<Impl>
 
     ~BaseO3DynInst();
 
+    /** @{ */
+    /**
+     * Dynamic instructions are created and destroyed at the fetch rate,
+     * so their memory is recycled through a free list instead of going
+     * back to the heap every time.
+     */
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr, size_t size);
+    /** @} */
+
     /** Executes the instruction.*/
     Fault execute();
 
@@ -99,6 +109,26 @@ class BaseO3DynInst : public BaseDynInst<Impl>
     /** Initializes variables. */
     void initVars();
 
+    /** A free block of instruction storage. */
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    /** Head of the list of free blocks.  CPUs in different event queues
+     *  may run on different threads, so every thread has its own list.
+     */
+    static thread_local FreeBlock *freeList;
+
+    /** Number of blocks on the free list. */
+    static thread_local unsigned numFreeBlocks;
+
+    /** Largest number of free blocks kept.  This is more instructions
+     *  than the largest configurations have in flight; storage freed
+     *  beyond it, e.g. after switching out a CPU, goes back to the heap.
+     */
+    static const unsigned maxFreeBlocks = 2048;
+
   protected:
     /** Explicitation of dependent names. */
     using BaseDynInst<Impl>::cpu;
@@ -99,6 +99,40 @@ template <class Impl>BaseO3DynInst<Impl>::~BaseO3DynInst()
 };
 
 
+template <class Impl>
+thread_local typename BaseO3DynInst<Impl>::FreeBlock *
+BaseO3DynInst<Impl>::freeList = nullptr;
+
+template <class Impl>
+thread_local unsigned BaseO3DynInst<Impl>::numFreeBlocks = 0;
+
+template <class Impl>
+void *
+BaseO3DynInst<Impl>::operator new(size_t size)
+{
+    if (size == sizeof(BaseO3DynInst) && freeList) {
+        FreeBlock *block = freeList;
+        freeList = block->next;
+        numFreeBlocks--;
+        return block;
+    }
+    return ::operator new(size);
+}
+
+template <class Impl>
+void
+BaseO3DynInst<Impl>::operator delete(void *ptr, size_t size)
+{
+    if (size != sizeof(BaseO3DynInst) || numFreeBlocks >= maxFreeBlocks) {
+        ::operator delete(ptr);
+        return;
+    }
+    FreeBlock *block = static_cast<FreeBlock *>(ptr);
+    block->next = freeList;
+    freeList = block;
+    numFreeBlocks++;
+}
+
 template <class Impl>
 void
 BaseO3DynInst<Impl>::initVars()
@@ -42,6 +42,7 @@
 #ifndef __CPU_O3_INST_QUEUE_HH__
 #define __CPU_O3_INST_QUEUE_HH__
 
+#include <deque>
 #include <list>
 #include <map>
 #include <queue>
@@ -49,6 +50,7 @@
 
 #include "base/statistics.hh"
 #include "base/types.hh"
+#include "cpu/o3/age_matrix.hh"
 #include "cpu/o3/dep_graph.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/op_class.hh"
@@ -313,8 +315,11 @@ class InstructionQueue
     /** List of all the instructions in the IQ (some of which may be issued). */
     std::list<DynInstPtr> instList[Impl::MaxThreads];
 
-    /** List of instructions that are ready to be executed. */
-    std::list<DynInstPtr> instsToExecute;
+    /** Instructions that are ready to be executed, in issue order.  This
+     *  is only ever used as a FIFO, so it does not need a list node per
+     *  instruction.
+     */
+    std::deque<DynInstPtr> instsToExecute;
 
     /** List of instructions waiting for their DTB translation to
      *  complete (hw page table walk in progress).
@@ -329,27 +334,13 @@ class InstructionQueue
      */
     std::list<DynInstPtr> retryMemInsts;
 
-    /**
-     * Struct for comparing entries to be added to the priority queue.
-     * This gives reverse ordering to the instructions in terms of
-     * sequence numbers: the instructions with smaller sequence
-     * numbers (and hence are older) will be at the top of the
-     * priority queue.
+    /** Instructions that are ready to issue, grouped by op class to allow
+     *  for easy mapping to FUs.  The age matrix picks the oldest of them
+     *  among the op classes whose FUs are not all busy.  It starts with a
+     *  slot per IQ entry; squashed instructions stay in it until they are
+     *  picked, so it may grow beyond that.
      */
-    struct pqCompare {
-        bool operator() (const DynInstPtr &lhs, const DynInstPtr &rhs) const
-        {
-            return lhs->seqNum > rhs->seqNum;
-        }
-    };
-
-    typedef std::priority_queue<DynInstPtr, std::vector<DynInstPtr>, pqCompare>
-    ReadyInstQueue;
-
-    /** List of ready instructions, per op class.  They are separated by op
-     *  class to allow for easy mapping to FUs.
-     */
-    ReadyInstQueue readyInsts[Num_OpClasses];
+    AgeMatrix<DynInstPtr> readyInsts;
 
     /** List of non-speculative instructions that will be scheduled
      *  once the IQ gets a signal from commit.  While it's redundant to
@@ -362,39 +353,8 @@ class InstructionQueue
 
     typedef typename std::map<InstSeqNum, DynInstPtr>::iterator NonSpecMapIt;
 
-    /** Entry for the list age ordering by op class. */
-    struct ListOrderEntry {
-        OpClass queueType;
-        InstSeqNum oldestInst;
-    };
-
-    /** List that contains the age order of the oldest instruction of each
-     *  ready queue.  Used to select the oldest instruction available
-     *  among op classes.
-     *  @todo: Might be better to just move these entries around instead
-     *  of creating new ones every time the position changes due to an
-     *  instruction issuing.  Not sure std::list supports this.
-     */
-    std::list<ListOrderEntry> listOrder;
-
-    typedef typename std::list<ListOrderEntry>::iterator ListOrderIt;
-
-    /** Tracks if each ready queue is on the age order list. */
-    bool queueOnList[Num_OpClasses];
-
-    /** Iterators of each ready queue.  Points to their spot in the age order
-     *  list.
-     */
-    ListOrderIt readyIt[Num_OpClasses];
-
-    /** Add an op class to the age order list. */
-    void addToOrderList(OpClass op_class);
-
-    /**
-     * Called when the oldest instruction has been removed from a ready queue;
-     * this places that ready queue into the proper spot in the age order list.
-     */
-    void moveToYoungerInst(ListOrderIt age_order_it);
+    /** Add an instruction to the ready instructions of its op class. */
+    void pushReadyInst(const DynInstPtr &inst, OpClass op_class);
 
     DependencyGraph<DynInstPtr> dependGraph;
 
@@ -796,6 +796,13 @@ LSQ<Impl>::SingleDataRequest::finish(const Fault &fault, const RequestPtr &req,
 
         LSQRequest::_inst->fault = fault;
         LSQRequest::_inst->translationCompleted(true);
+
+        // A delayed translation completes outside of the CPU tick, and the
+        // IQ does not poll its deferred instructions, so make sure the CPU
+        // is ticking to pick this one up.
+        if (this->isDelayed()) {
+            _port.wakeCPU();
+        }
     }
 }
 
@@ -843,6 +850,10 @@ LSQ<Impl>::SplitDataRequest::finish(const Fault &fault, const RequestPtr &req,
                 _inst->fault = _fault[0];
                 setState(State::Fault);
             }
+
+            if (this->isDelayed()) {
+                _port.wakeCPU();
+            }
         }
 
     }
@@ -387,6 +387,9 @@ class LSQUnit
 
     BaseTLB* dTLB() { return cpu->dtb; }
 
+    /** Wakes up the CPU if it is idle. */
+    void wakeCPU() { cpu->wakeCPU(); }
+
   private:
     /** Pointer to the CPU. */
     O3CPU *cpu;
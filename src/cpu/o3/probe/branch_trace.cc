@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/o3/probe/branch_trace.hh"
+
+#include "base/callback.hh"
+#include "base/output.hh"
+#include "base/trace.hh"
+#include "config/the_isa.hh"
+#include "debug/BranchTrace.hh"
+#include "proto/branch.pb.h"
+
+namespace
+{
+
+/** Size in bytes of the instruction at the given PC. */
+unsigned
+instSize(const TheISA::PCState &pc)
+{
+#if THE_ISA == X86_ISA
+    return pc.size();
+#else
+    return sizeof(TheISA::MachInst);
+#endif
+}
+
+} // anonymous namespace
+
+BranchTrace::BranchTrace(const BranchTraceParams *params)
+    : ProbeListenerObject(params), traceStream(nullptr), lastNextPC(0),
+      pendingInsts(0)
+{
+    auto *cpu = dynamic_cast<FullO3CPU<O3CPUImpl> *>(params->manager);
+    fatal_if(!cpu, "Manager of %s is not of type O3CPU and thus does not "
+             "support branch tracing.\n", name());
+    fatal_if(cpu->numThreads > 1, "numThreads = %i, %s supports tracing "
+             "for single-threaded workloads only", cpu->numThreads, name());
+    fatal_if(params->traceFile == "", "Assign the branch trace file path "
+             "to traceFile");
+
+    traceStream = new ProtoOutputStream(
+        simout.resolve(name() + "." + params->traceFile));
+
+    ProtoMessage::BranchHeader header;
+    header.set_obj_id(name());
+    traceStream->write(header);
+
+    registerExitCallback(
+        new MakeCallback<BranchTrace, &BranchTrace::flushTrace>(this));
+}
+
+void
+BranchTrace::regProbeListeners()
+{
+    listeners.push_back(new ProbeListenerArg<BranchTrace, DynInstConstPtr>(
+                this, "Commit", &BranchTrace::recordCommit));
+}
+
+void
+BranchTrace::recordCommit(const DynInstConstPtr &dyn_inst)
+{
+    // Count macro-ops, so that the MPKI of a replay is comparable to
+    // the one of the simulation the trace was taken from
+    if (!dyn_inst->isMicroop() || dyn_inst->isLastMicroop())
+        pendingInsts++;
+
+    if (!dyn_inst->isControl())
+        return;
+
+    // The PC state of a committed instruction has been updated with the
+    // outcome of the branch, so advancing it gives the actual next PC
+    TheISA::PCState pc = dyn_inst->pcState();
+    TheISA::PCState next_pc = pc;
+    TheISA::advancePC(next_pc, dyn_inst->staticInst);
+    const bool taken = pc.branching();
+    const unsigned size = instSize(pc);
+
+    uint32_t flags = 0;
+    if (dyn_inst->isCondCtrl())
+        flags |= ProtoMessage::Branch::Conditional;
+    if (dyn_inst->isDirectCtrl())
+        flags |= ProtoMessage::Branch::Direct;
+    if (dyn_inst->isCall())
+        flags |= ProtoMessage::Branch::Call;
+    if (dyn_inst->isReturn())
+        flags |= ProtoMessage::Branch::Return;
+    if (taken)
+        flags |= ProtoMessage::Branch::Taken;
+
+    DPRINTFR(BranchTrace, "[sn:%lli] Branch %#x -> %#x flags %#x insts %u\n",
+             dyn_inst->seqNum, pc.instAddr(), next_pc.instAddr(), flags,
+             pendingInsts);
+
+    ProtoMessage::Branch branch;
+    branch.set_pc_delta(pc.instAddr() - lastNextPC);
+    branch.set_flags(flags);
+    if (taken)
+        branch.set_target_delta(next_pc.instAddr() - pc.instAddr());
+    if (pendingInsts != 1)
+        branch.set_insts(pendingInsts);
+    if (size != sizeof(TheISA::MachInst))
+        branch.set_size(size);
+    traceStream->write(branch);
+
+    lastNextPC = taken ? next_pc.instAddr() : pc.instAddr();
+    pendingInsts = 0;
+}
+
+void
+BranchTrace::flushTrace()
+{
+    delete traceStream;
+    traceStream = nullptr;
+}
+
+BranchTrace *
+BranchTraceParams::create()
+{
+    return new BranchTrace(this);
+}
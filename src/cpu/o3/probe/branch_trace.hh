@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file This file describes a probe listener which records the control
+ * instructions committed by an O3 CPU in a compact protobuf branch trace
+ * that can be replayed against stand-alone branch predictors.
+ */
+
+#ifndef __CPU_O3_PROBE_BRANCH_TRACE_HH__
+#define __CPU_O3_PROBE_BRANCH_TRACE_HH__
+
+#include "cpu/o3/dyn_inst.hh"
+#include "cpu/o3/impl.hh"
+#include "params/BranchTrace.hh"
+#include "proto/protoio.hh"
+#include "sim/probe/probe.hh"
+
+class BranchTrace : public ProbeListenerObject
+{
+  public:
+    typedef O3CPUImpl::DynInstConstPtr DynInstConstPtr;
+
+    BranchTrace(const BranchTraceParams *params);
+
+    /** Register the probe listeners. */
+    void regProbeListeners() override;
+
+    /** Flush the buffered records and close the trace. */
+    void flushTrace();
+
+  private:
+    /** Record a committed instruction. */
+    void recordCommit(const DynInstConstPtr &dyn_inst);
+
+    /** Output stream of the trace, owned by this object. */
+    ProtoOutputStream *traceStream;
+
+    /** Next PC of the last recorded branch, the base of the deltas. */
+    Addr lastNextPC;
+
+    /** Instructions committed since the last recorded branch. */
+    uint32_t pendingInsts;
+};
+
+#endif // __CPU_O3_PROBE_BRANCH_TRACE_HH__
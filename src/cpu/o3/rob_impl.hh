@@ -56,6 +56,8 @@ ROB<Impl>::ROB(O3CPU *_cpu, DerivO3CPUParams *params)
     : robPolicy(params->smtROBPolicy),
       cpu(_cpu),
       numEntries(params->numROBEntries),
+      instList(Impl::MaxThreads,
+               CircularQueue<DynInstPtr>(params->numROBEntries)),
       squashWidth(params->squashWidth),
       numInstsInROB(0),
       numThreads(params->numThreads)
@@ -102,7 +104,7 @@ ROB<Impl>::resetState()
 {
     for (ThreadID tid = 0; tid  < Impl::MaxThreads; tid++) {
         threadEntries[tid] = 0;
-        squashIt[tid] = instList[tid].end();
+        squashIt[tid] = InstIt();
         squashedSeqNum[tid] = 0;
         doneSquashing[tid] = true;
     }
@@ -220,10 +222,7 @@ ROB<Impl>::insertInst(const DynInstPtr &inst)
         assert((*head) == inst);
     }
 
-    //Must Decrement for iterator to actually be valid  since __.end()
-    //actually points to 1 after the last inst
-    tail = instList[tid].end();
-    tail--;
+    tail = instList[tid].getIterator(instList[tid].tail());
 
     inst->setInROB();
 
@@ -243,11 +242,10 @@ ROB<Impl>::retireHead(ThreadID tid)
 
     assert(numInstsInROB > 0);
 
-    // Get the head ROB instruction by copying it and remove it from the list
-    InstIt head_it = instList[tid].begin();
-
-    DynInstPtr head_inst = std::move(*head_it);
-    instList[tid].erase(head_it);
+    // Get the head ROB instruction by moving it out of the list, so that
+    // the slot does not keep the instruction alive, and remove it.
+    DynInstPtr head_inst = std::move(instList[tid].front());
+    instList[tid].pop_front();
 
     assert(head_inst->readyToCommit());
 
@@ -323,14 +321,12 @@ ROB<Impl>::doSquash(ThreadID tid)
     DPRINTF(ROB, "[tid:%i] Squashing instructions until [sn:%llu].\n",
             tid, squashedSeqNum[tid]);
 
-    assert(squashIt[tid] != instList[tid].end());
+    assert(!doneSquashing[tid]);
 
     if ((*squashIt[tid])->seqNum < squashedSeqNum[tid]) {
         DPRINTF(ROB, "[tid:%i] Done squashing instructions.\n",
                 tid);
 
-        squashIt[tid] = instList[tid].end();
-
         doneSquashing[tid] = true;
         return;
     }
@@ -339,7 +335,6 @@ ROB<Impl>::doSquash(ThreadID tid)
 
     for (int numSquashed = 0;
          numSquashed < squashWidth &&
-         squashIt[tid] != instList[tid].end() &&
          (*squashIt[tid])->seqNum > squashedSeqNum[tid];
          ++numSquashed)
     {
@@ -359,17 +354,12 @@ ROB<Impl>::doSquash(ThreadID tid)
             DPRINTF(ROB, "Reached head of instruction list while "
                     "squashing.\n");
 
-            squashIt[tid] = instList[tid].end();
-
             doneSquashing[tid] = true;
 
             return;
         }
 
-        InstIt tail_thread = instList[tid].end();
-        tail_thread--;
-
-        if ((*squashIt[tid]) == (*tail_thread))
+        if ((*squashIt[tid]) == instList[tid].back())
             robTailUpdate = true;
 
         squashIt[tid]--;
@@ -381,8 +371,6 @@ ROB<Impl>::doSquash(ThreadID tid)
         DPRINTF(ROB, "[tid:%i] Done squashing instructions.\n",
                 tid);
 
-        squashIt[tid] = instList[tid].end();
-
         doneSquashing[tid] = true;
     }
 
@@ -454,16 +442,14 @@ ROB<Impl>::updateTail()
         // If this is the first valid then assign w/out
         // comparison
         if (first_valid) {
-            tail = instList[tid].end();
-            tail--;
+            tail = instList[tid].getIterator(instList[tid].tail());
             first_valid = false;
             continue;
         }
 
         // Assign new tail if this thread's tail is younger
         // than our current "tail high"
-        InstIt tail_thread = instList[tid].end();
-        tail_thread--;
+        InstIt tail_thread = instList[tid].getIterator(instList[tid].tail());
 
         if ((*tail_thread)->seqNum > (*tail)->seqNum) {
             tail = tail_thread;
@@ -493,10 +479,7 @@ ROB<Impl>::squash(InstSeqNum squash_num, ThreadID tid)
     squashedSeqNum[tid] = squash_num;
 
     if (!instList[tid].empty()) {
-        InstIt tail_thread = instList[tid].end();
-        tail_thread--;
-
-        squashIt[tid] = tail_thread;
+        squashIt[tid] = instList[tid].getIterator(instList[tid].tail());
 
         doSquash(tid);
     }
@@ -507,11 +490,11 @@ const typename Impl::DynInstPtr&
 ROB<Impl>::readHeadInst(ThreadID tid)
 {
     if (threadEntries[tid] != 0) {
-        InstIt head_thread = instList[tid].begin();
+        const DynInstPtr &head_inst = instList[tid].front();
 
-        assert((*head_thread)->isInROB());
+        assert(head_inst->isInROB());
 
-        return *head_thread;
+        return head_inst;
     } else {
         return dummyInst;
     }
@@ -521,10 +504,7 @@ template <class Impl>
 typename Impl::DynInstPtr
 ROB<Impl>::readTailInst(ThreadID tid)
 {
-    InstIt tail_thread = instList[tid].end();
-    tail_thread--;
-
-    return *tail_thread;
+    return instList[tid].back();
 }
 
 template <class Impl>
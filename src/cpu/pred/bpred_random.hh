@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Random number generator used by the branch predictors.
+ */
+
+#ifndef __CPU_PRED_BPRED_RANDOM_HH__
+#define __CPU_PRED_BPRED_RANDOM_HH__
+
+#include "base/random.hh"
+
+/**
+ * Generator replacing random_mt for the predictors simulated by the
+ * current host thread, if any. Set with ScopedBPredRandom.
+ */
+extern thread_local Random *bpredRandomOverride;
+
+/**
+ * Get the generator the branch predictors draw from: random_mt, unless
+ * the current host thread replays predictors with a generator of its own
+ * (e.g., BranchTraceEval).
+ */
+inline Random &
+bpredRandom()
+{
+    return bpredRandomOverride ? *bpredRandomOverride : random_mt;
+}
+
+/**
+ * Make the predictors simulated by the current host thread draw from a
+ * given generator while this object is alive.
+ */
+class ScopedBPredRandom
+{
+  private:
+    Random *const previous;
+
+  public:
+    ScopedBPredRandom(Random &rng)
+        : previous(bpredRandomOverride)
+    {
+        bpredRandomOverride = &rng;
+    }
+
+    ~ScopedBPredRandom()
+    {
+        bpredRandomOverride = previous;
+    }
+
+    ScopedBPredRandom(const ScopedBPredRandom &) = delete;
+    ScopedBPredRandom &operator=(const ScopedBPredRandom &) = delete;
+};
+
+#endif // __CPU_PRED_BPRED_RANDOM_HH__
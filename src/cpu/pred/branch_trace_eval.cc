@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/pred/branch_trace_eval.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "base/logging.hh"
+#include "base/random.hh"
+#include "cpu/pred/bpred_random.hh"
+#include "proto/branch.pb.h"
+#include "proto/protoio.hh"
+#include "sim/sim_exit.hh"
+
+namespace
+{
+
+TheISA::ExtMachInst traceBranchMachInst;
+
+/** Kind bits of the trace flags, everything but the outcome. */
+const uint32_t branchKindMask = ProtoMessage::Branch::Conditional |
+                                ProtoMessage::Branch::Direct |
+                                ProtoMessage::Branch::Call |
+                                ProtoMessage::Branch::Return;
+
+/**
+ * Stand-in for the branch instructions of a trace, carrying just the
+ * control flags the predictors look at.
+ */
+class TraceBranchInst : public StaticInst
+{
+  public:
+    TraceBranchInst(uint32_t kind)
+        : StaticInst("trace branch", traceBranchMachInst, No_OpClass)
+    {
+        flags[IsControl] = true;
+        if (kind & ProtoMessage::Branch::Conditional)
+            flags[IsCondControl] = true;
+        else
+            flags[IsUncondControl] = true;
+        if (kind & ProtoMessage::Branch::Direct)
+            flags[IsDirectControl] = true;
+        else
+            flags[IsIndirectControl] = true;
+        flags[IsCall] = kind & ProtoMessage::Branch::Call;
+        flags[IsReturn] = kind & ProtoMessage::Branch::Return;
+    }
+
+    Fault
+    execute(ExecContext *xc, Trace::InstRecord *traceData) const override
+    {
+        panic("Trace branches cannot be executed.\n");
+    }
+
+    void
+    advancePC(TheISA::PCState &pcState) const override
+    {
+        pcState.advance();
+    }
+
+    std::string
+    generateDisassembly(Addr pc,
+            const Loader::SymbolTable *symtab) const override
+    {
+        return mnemonic;
+    }
+};
+
+} // anonymous namespace
+
+BranchTraceEval::BranchTraceEval(const BranchTraceEvalParams *p)
+    : SimObject(p), traceFile(p->traceFile), predictors(p->predictors),
+      hostThreads(p->hostThreads), maxBranches(p->maxBranches),
+      seed(p->seed), replayEvent([this]{ replay(); }, name())
+{
+    fatal_if(predictors.empty(), "%s has no predictor to evaluate.\n",
+             name());
+}
+
+void
+BranchTraceEval::startup()
+{
+    schedule(replayEvent, curTick());
+}
+
+void
+BranchTraceEval::regStats()
+{
+    SimObject::regStats();
+
+    insts
+        .name(name() + ".insts")
+        .desc("Number of instructions covered by the trace")
+        ;
+
+    branches
+        .name(name() + ".branches")
+        .desc("Number of branches replayed")
+        ;
+
+    condBranches
+        .name(name() + ".condBranches")
+        .desc("Number of conditional branches replayed")
+        ;
+
+    mispredicts
+        .init(predictors.size())
+        .name(name() + ".mispredicts")
+        .desc("Number of branches with a mispredicted next PC")
+        .flags(Stats::nozero)
+        ;
+
+    condMispredicts
+        .init(predictors.size())
+        .name(name() + ".condMispredicts")
+        .desc("Number of conditional branches with a mispredicted "
+              "direction")
+        .flags(Stats::nozero)
+        ;
+
+    mpki
+        .name(name() + ".mpki")
+        .desc("Mispredicted next PCs per thousand instructions")
+        .precision(4)
+        ;
+    mpki = mispredicts * 1000 / insts;
+
+    condMpki
+        .name(name() + ".condMpki")
+        .desc("Mispredicted conditional directions per thousand "
+              "instructions")
+        .precision(4)
+        ;
+    condMpki = condMispredicts * 1000 / insts;
+
+    for (size_t i = 0; i < predictors.size(); i++) {
+        const std::string &bp_name = predictors[i]->name();
+        mispredicts.subname(i, bp_name);
+        condMispredicts.subname(i, bp_name);
+        mpki.subname(i, bp_name);
+        condMpki.subname(i, bp_name);
+    }
+}
+
+void
+BranchTraceEval::replay()
+{
+    std::vector<Result> results(predictors.size());
+    std::atomic<size_t> next_predictor(0);
+
+    // The replay runs on worker threads only. Each predictor is replayed
+    // with a generator of its own (see replayOne()), so that the results
+    // do not depend on the number of threads or the state of the
+    // simulation's generator
+    auto worker = [&](EventQueue *eq) {
+        // Debug output of the predictors needs a current tick
+        curEventQueue(eq);
+        size_t i;
+        while ((i = next_predictor++) < predictors.size())
+            results[i] = replayOne(*predictors[i]);
+    };
+
+    size_t num_threads = hostThreads ? hostThreads : predictors.size();
+    num_threads = std::min(num_threads, predictors.size());
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; t++)
+        threads.emplace_back(worker, eventQueue());
+    for (auto &thread : threads)
+        thread.join();
+
+    // All predictors saw the same branches
+    insts = results[0].insts;
+    branches = results[0].branches;
+    condBranches = results[0].condBranches;
+    for (size_t i = 0; i < predictors.size(); i++) {
+        mispredicts[i] = results[i].mispredicts;
+        condMispredicts[i] = results[i].condMispredicts;
+        inform("%s: %llu branches, %llu mispredicted, MPKI %.4f\n",
+               predictors[i]->name(), results[i].branches,
+               results[i].mispredicts, results[i].insts ?
+               1000.0 * results[i].mispredicts / results[i].insts : 0.0);
+    }
+
+    exitSimLoop("branch trace replay complete");
+}
+
+BranchTraceEval::Result
+BranchTraceEval::replayOne(BPredUnit &bp) const
+{
+    // The predictors draw from a generator of this thread, seeded the
+    // same way for every predictor
+    Random rng(seed);
+    ScopedBPredRandom scoped_rng(rng);
+
+    // Instructions are per thread as the reference counts of
+    // StaticInstPtr are not atomic
+    StaticInstPtr branch_insts[branchKindMask + 1];
+    for (uint32_t kind = 0; kind <= branchKindMask; kind++)
+        branch_insts[kind] = new TraceBranchInst(kind);
+
+    ProtoInputStream trace(traceFile);
+    ProtoMessage::BranchHeader header;
+    fatal_if(!trace.read(header), "Failed to read the header of branch "
+             "trace %s.\n", traceFile);
+
+    Result result;
+    ProtoMessage::Branch branch;
+    Addr next_pc = 0;
+    InstSeqNum seq_num = 0;
+    const ThreadID tid = 0;
+
+    while ((!maxBranches || result.branches < maxBranches) &&
+           trace.read(branch)) {
+        const uint32_t flags = branch.flags();
+        const bool cond = flags & ProtoMessage::Branch::Conditional;
+        const bool taken = flags & ProtoMessage::Branch::Taken;
+        const StaticInstPtr &inst = branch_insts[flags & branchKindMask];
+        const Addr pc = next_pc + branch.pc_delta();
+
+        // The predictors take the return address of calls, and the next
+        // PC of branches they do not predict taken, from the next PC of
+        // the PC state, so it has to skip over the branch exactly
+        TheISA::PCState pc_state(pc);
+        if (branch.has_size())
+            pc_state.npc(pc + branch.size());
+
+        TheISA::PCState actual_pc(pc_state);
+        if (taken)
+            actual_pc = TheISA::PCState(pc + branch.target_delta());
+        else
+            inst->advancePC(actual_pc);
+
+        TheISA::PCState pred_pc(pc_state);
+        const bool pred_taken = bp.predict(inst, ++seq_num, pred_pc, tid);
+
+        if (pred_taken != taken ||
+            pred_pc.instAddr() != actual_pc.instAddr()) {
+            result.mispredicts++;
+            if (cond && pred_taken != taken)
+                result.condMispredicts++;
+            bp.squash(seq_num, actual_pc, taken, tid);
+        }
+        bp.update(seq_num, tid);
+
+        result.insts += branch.insts();
+        result.branches++;
+        if (cond)
+            result.condBranches++;
+        next_pc = taken ? actual_pc.instAddr() : pc;
+    }
+
+    return result;
+}
+
+BranchTraceEval *
+BranchTraceEvalParams::create()
+{
+    return new BranchTraceEval(this);
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Replay of recorded branch traces against stand-alone branch predictors.
+ */
+
+#ifndef __CPU_PRED_BRANCH_TRACE_EVAL_HH__
+#define __CPU_PRED_BRANCH_TRACE_EVAL_HH__
+
+#include <string>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "cpu/pred/bpred_unit.hh"
+#include "params/BranchTraceEval.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+/**
+ * Evaluates branch predictors on a branch trace recorded by the
+ * BranchTrace probe listener, without simulating a CPU. Every branch of
+ * the trace goes through BPredUnit::predict(), and through squash() when
+ * the predicted next PC is wrong, before being committed with update(),
+ * the same sequence a CPU performs when branches resolve in order. The
+ * predictors therefore exercise their BTB, RAS and indirect predictor
+ * as well, and their own statistics are updated as in a simulation.
+ *
+ * The predictors are independent, so each one reads the trace on its
+ * own and they are spread over a number of host threads. The replay
+ * happens at the start of the simulation, which then exits.
+ */
+class BranchTraceEval : public SimObject
+{
+  public:
+    BranchTraceEval(const BranchTraceEvalParams *p);
+
+    void startup() override;
+    void regStats() override;
+
+  private:
+    /** Outcome of the replay of the trace against one predictor. */
+    struct Result
+    {
+        uint64_t insts = 0;
+        uint64_t branches = 0;
+        uint64_t condBranches = 0;
+        uint64_t mispredicts = 0;
+        uint64_t condMispredicts = 0;
+    };
+
+    /** Replay the trace against all predictors and exit. */
+    void replay();
+
+    /**
+     * Replay the trace against one predictor. This runs on a host
+     * thread of its own and only touches the predictor.
+     */
+    Result replayOne(BPredUnit &bp) const;
+
+    const std::string traceFile;
+    const std::vector<BPredUnit *> predictors;
+    const unsigned hostThreads;
+    const uint64_t maxBranches;
+    const uint32_t seed;
+
+    EventFunctionWrapper replayEvent;
+
+    /** Instructions covered by the replayed branches. */
+    Stats::Scalar insts;
+    Stats::Scalar branches;
+    Stats::Scalar condBranches;
+
+    /** Branches whose predicted next PC was wrong, per predictor. */
+    Stats::Vector mispredicts;
+    /** Mispredicted directions of conditional branches, per predictor. */
+    Stats::Vector condMispredicts;
+
+    Stats::Formula mpki;
+    Stats::Formula condMpki;
+};
+
+#endif // __CPU_PRED_BRANCH_TRACE_EVAL_HH__
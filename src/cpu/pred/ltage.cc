@@ -39,8 +39,8 @@
 
 #include "base/intmath.hh"
 #include "base/logging.hh"
-#include "base/random.hh"
 #include "base/trace.hh"
+#include "cpu/pred/bpred_random.hh"
 #include "debug/Fetch.hh"
 #include "debug/LTage.hh"
 
@@ -108,7 +108,7 @@ LTAGE::update(ThreadID tid, Addr branch_pc, bool taken, void* bp_history,
         return;
     }
 
-    int nrand = random_mt.random<int>() & 3;
+    int nrand = bpredRandom().random<int>() & 3;
     if (bi->tageBranchInfo->condBranch) {
         DPRINTF(LTage, "Updating tables for branch:%lx; taken?:%d\n",
                 branch_pc, taken);
@@ -38,7 +38,7 @@
 
 #include "cpu/pred/multiperspective_perceptron.hh"
 
-#include "base/random.hh"
+#include "cpu/pred/bpred_random.hh"
 #include "debug/Branch.hh"
 
 int
@@ -494,7 +494,7 @@ MultiperspectivePerceptron::train(ThreadID tid, MPPBranchInfo &bi, bool taken)
             do {
                 // udpate a random weight
                 int besti = -1;
-                int nrand = random_mt.random<int>() % specs.size();
+                int nrand = bpredRandom().random<int>() % specs.size();
                 int pout;
                 found = false;
                 for (int j = 0; j < specs.size(); j += 1) {
@@ -656,7 +656,7 @@ MultiperspectivePerceptron::update(ThreadID tid, Addr instPC, bool taken,
         // filter, blow a random filter entry away
         if (decay && transition &&
             ((threadData[tid]->occupancy > decay) || (decay == 1))) {
-            int rnd = random_mt.random<int>() %
+            int rnd = bpredRandom().random<int>() %
                       threadData[tid]->filterTable.size();
             FilterEntry &frand = threadData[tid]->filterTable[rnd];
             if (frand.seenTaken && frand.seenUntaken) {
@@ -38,7 +38,7 @@
 
 #include "cpu/pred/multiperspective_perceptron_tage.hh"
 
-#include "base/random.hh"
+#include "cpu/pred/bpred_random.hh"
 
 void
 MPP_TAGE::calculateParameters()
@@ -95,7 +95,7 @@ MPP_TAGE::handleAllocAndUReset(bool alloc, bool taken,
 
     int a = 1;
 
-    if ((random_mt.random<int>() & 127) < 32) {
+    if ((bpredRandom().random<int>() & 127) < 32) {
         a = 2;
     }
     int dep = bi->hitBank + a;
@@ -178,7 +178,7 @@ void
 MPP_TAGE::adjustAlloc(bool & alloc, bool taken, bool pred_taken)
 {
     // Do not allocate too often if the prediction is ok
-    if ((taken == pred_taken) && ((random_mt.random<int>() & 31) != 0)) {
+    if ((taken == pred_taken) && ((bpredRandom().random<int>() & 31) != 0)) {
         alloc = false;
     }
 }
@@ -258,7 +258,7 @@ MPP_LoopPredictor::calcConf(int index) const
 bool
 MPP_LoopPredictor::optionalAgeInc() const
 {
-    return ((random_mt.random<int>() & 7) == 0);
+    return ((bpredRandom().random<int>() & 7) == 0);
 }
 
 MPP_LoopPredictor*
@@ -641,7 +641,7 @@ MultiperspectivePerceptronTAGE::update(ThreadID tid, Addr instPC, bool taken,
                 tage->getPathHist(tid));
 
         tage->condBranchUpdate(tid, instPC, taken, bi->tageBranchInfo,
-                               random_mt.random<int>(), corrTarget,
+                               bpredRandom().random<int>(), corrTarget,
                                bi->predictedTaken, true);
 
         updateHistories(tid, *bi, taken);
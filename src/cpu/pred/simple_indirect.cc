@@ -29,6 +29,7 @@
 #include "cpu/pred/simple_indirect.hh"
 
 #include "base/intmath.hh"
+#include "cpu/pred/bpred_random.hh"
 #include "debug/Indirect.hh"
 
 SimpleIndirectPredictor::SimpleIndirectPredictor(
@@ -201,8 +202,13 @@ SimpleIndirectPredictor::recordTarget(
 
     DPRINTF(Indirect, "Allocating Target (seq: %d br:%x set:%d target:%s)\n",
             seq_num, hist_entry.pcAddr, set_index, target);
-    // Did not find entry, random replacement
-    auto &way = iset[rand() % numWays];
+    // Did not find entry, random replacement. rand() is shared by all
+    // host threads, so threads replaying predictors use their own
+    // generator instead.
+    const unsigned victim = bpredRandomOverride ?
+        bpredRandomOverride->random<unsigned>(0, numWays - 1) :
+        rand() % numWays;
+    auto &way = iset[victim];
     way.tag = tag;
     way.target = target;
 }
@@ -131,7 +131,16 @@ TAGEBase::init()
     btableHysteresis.resize(bimodalTableSize >> logRatioBiModalHystEntries,
                             true);
 
-    gtable = new TageEntry*[nHistoryTables + 1];
+    // The tables that hit are tracked in a 64-bit mask
+    assert(nHistoryTables < 64);
+    noSkipMask = 0;
+    for (int i = 1; i <= nHistoryTables; i++) {
+        if (noSkip[i]) {
+            noSkipMask |= ULL(1) << i;
+        }
+    }
+
+    gtable = new TageTable[nHistoryTables + 1];
     buildTageTables();
 
     tableIndices = new int [nHistoryTables+1];
@@ -158,7 +167,7 @@ void
 TAGEBase::buildTageTables()
 {
     for (int i = 1; i <= nHistoryTables; i++) {
-        gtable[i] = new TageEntry[1<<(logTagTableSizes[i])];
+        gtable[i].allocate(1<<(logTagTableSizes[i]));
     }
 }
 
@@ -364,22 +373,24 @@ TAGEBase::tagePredict(ThreadID tid, Addr branch_pc,
 
         bi->hitBank = 0;
         bi->altBank = 0;
-        //Look for the bank with longest matching history
-        for (int i = nHistoryTables; i > 0; i--) {
-            if (noSkip[i] &&
-                gtable[i][tableIndices[i]].tag == tableTags[i]) {
-                bi->hitBank = i;
-                bi->hitBankIndex = tableIndices[bi->hitBank];
-                break;
-            }
+        //Compare the tags of all the tables without branching, the
+        //longest matching history is the highest bit set in the mask
+        //and the alternate bank the next one
+        uint64_t hits = 0;
+        for (int i = 1; i <= nHistoryTables; i++) {
+            //Skipped tables may not have a valid index, probe their
+            //first entry instead and mask them out
+            const int idx = (noSkipMask >> i) & 1 ? tableIndices[i] : 0;
+            hits |= (uint64_t)(gtable[i].tag[idx] == tableTags[i]) << i;
         }
-        //Look for the alternate bank
-        for (int i = bi->hitBank - 1; i > 0; i--) {
-            if (noSkip[i] &&
-                gtable[i][tableIndices[i]].tag == tableTags[i]) {
-                bi->altBank = i;
+        hits &= noSkipMask;
+        if (hits) {
+            bi->hitBank = floorLog2(hits);
+            bi->hitBankIndex = tableIndices[bi->hitBank];
+            hits &= ~(ULL(1) << bi->hitBank);
+            if (hits) {
+                bi->altBank = floorLog2(hits);
                 bi->altBankIndex = tableIndices[bi->altBank];
-                break;
             }
         }
         //computes the prediction and the alternate prediction
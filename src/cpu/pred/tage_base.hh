@@ -65,13 +65,40 @@ class TAGEBase : public SimObject
   protected:
     // Prediction Structures
 
-    // Tage Entry
+    // Tage Entry, refers to the fields of one entry of a TageTable
     struct TageEntry
     {
-        int8_t ctr;
-        uint16_t tag;
-        uint8_t u;
-        TageEntry() : ctr(0), tag(0), u(0) { }
+        int8_t &ctr;
+        uint16_t &tag;
+        uint8_t &u;
+    };
+
+    // Tagged table. Each field is kept in an array of its own, so that
+    // looking for the matching tables only reads tags, and walking the
+    // useful counters only reads those. Copying a TageTable makes
+    // another view of the same entries, which is how some predictors
+    // share the storage of several tables.
+    struct TageTable
+    {
+        int8_t *ctr;
+        uint16_t *tag;
+        uint8_t *u;
+
+        TageTable() : ctr(nullptr), tag(nullptr), u(nullptr) { }
+
+        void
+        allocate(size_t size)
+        {
+            ctr = new int8_t[size]();
+            tag = new uint16_t[size]();
+            u = new uint8_t[size]();
+        }
+
+        TageEntry
+        operator[](size_t idx) const
+        {
+            return TageEntry{ctr[idx], tag[idx], u[idx]};
+        }
     };
 
     // Folded History Table - compressed history
@@ -428,7 +455,7 @@ class TAGEBase : public SimObject
 
     std::vector<bool> btablePrediction;
     std::vector<bool> btableHysteresis;
-    TageEntry **gtable;
+    TageTable *gtable;
 
     // Keep per-thread histories to
     // support SMT.
@@ -476,6 +503,8 @@ class TAGEBase : public SimObject
     // (for the base TAGE implementation all are active)
     // Some other classes use this for handling associativity
     std::vector<bool> noSkip;
+    // Same as noSkip, as a bit mask over the tagged tables
+    uint64_t noSkipMask;
 
     const bool speculativeHistUpdate;
 
@@ -42,7 +42,7 @@
 
 #include "cpu/pred/tage_sc_l.hh"
 
-#include "base/random.hh"
+#include "cpu/pred/bpred_random.hh"
 #include "debug/TageSCL.hh"
 
 bool
@@ -55,7 +55,7 @@ TAGE_SC_L_LoopPredictor::calcConf(int index) const
 bool
 TAGE_SC_L_LoopPredictor::optionalAgeInc() const
 {
-    return (random_mt.random<int>() & 7) == 0;
+    return (bpredRandom().random<int>() & 7) == 0;
 }
 
 TAGE_SC_L_LoopPredictor *
@@ -113,9 +113,9 @@ TAGE_SC_L_TAGE::buildTageTables()
     // Trick! We only allocate entries for tables 1 and firstLongTagTable and
     // make the other tables point to these allocated entries
 
-    gtable[1] = new TageEntry[shortTagsTageFactor * (1 << logTagTableSize)];
-    gtable[firstLongTagTable] =
-        new TageEntry[longTagsTageFactor * (1 << logTagTableSize)];
+    gtable[1].allocate(shortTagsTageFactor * (1 << logTagTableSize));
+    gtable[firstLongTagTable].allocate(
+        longTagsTageFactor * (1 << logTagTableSize));
     for (int i = 2; i < firstLongTagTable; ++i) {
         gtable[i] = gtable[1];
     }
@@ -296,7 +296,7 @@ void
 TAGE_SC_L_TAGE::adjustAlloc(bool & alloc, bool taken, bool pred_taken)
 {
     // Do not allocate too often if the prediction is ok
-    if ((taken == pred_taken) && ((random_mt.random<int>() & 31) != 0)) {
+    if ((taken == pred_taken) && ((bpredRandom().random<int>() & 31) != 0)) {
         alloc = false;
     }
 }
@@ -305,11 +305,11 @@ int
 TAGE_SC_L_TAGE::calcDep(TAGEBase::BranchInfo* bi)
 {
     int a = 1;
-    if ((random_mt.random<int>() & 127) < 32) {
+    if ((bpredRandom().random<int>() & 127) < 32) {
         a = 2;
     }
     return ((((bi->hitBank - 1 + 2 * a) & 0xffe)) ^
-            (random_mt.random<int>() & 1));
+            (bpredRandom().random<int>() & 1));
 }
 
 void
@@ -431,7 +431,7 @@ TAGE_SC_L::update(ThreadID tid, Addr branch_pc, bool taken, void *bp_history,
         return;
     }
 
-    int nrand = random_mt.random<int>() & 3;
+    int nrand = bpredRandom().random<int>() & 3;
     if (tage_bi->condBranch) {
         DPRINTF(TageSCL, "Updating tables for branch:%lx; taken?:%d\n",
                 branch_pc, taken);
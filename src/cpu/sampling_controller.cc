@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/sampling_controller.hh"
+
+#include <cmath>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "cpu/thread_context.hh"
+#include "debug/Sampling.hh"
+#include "sim/sim_exit.hh"
+
+const char *const SamplingController::switchToDetailedCause =
+    "sampling: switch to detailed";
+const char *const SamplingController::switchToFunctionalCause =
+    "sampling: switch to functional";
+const char *const SamplingController::targetReachedCause =
+    "sampling: target error reached";
+
+SamplingController::SamplingController(const SamplingControllerParams *p)
+    : SimObject(p),
+      functionalCpus(p->functional_cpus), detailedCpus(p->detailed_cpus),
+      period(p->period), warmup(p->warmup), length(p->length),
+      confidenceZ(p->confidence_z), targetError(p->target_error),
+      minSamples(p->min_samples), maxSamples(p->max_samples),
+      phase(Phase::Functional),
+      phaseEndEvent([this]{ phaseEnd(); }, name()),
+      eventTC(nullptr), sampleStartTick(0), sampleStartInsts(0),
+      numSamples(0), cpiSum(0), cpiSquareSum(0), sampleStream(nullptr)
+{
+    fatal_if(functionalCpus.empty() ||
+             functionalCpus.size() != detailedCpus.size(),
+             "%s needs as many functional as detailed CPUs.\n", name());
+    fatal_if(!length, "%s: the sample length must be non-zero.\n", name());
+    fatal_if(warmup + length > period, "%s: the detailed warm-up and "
+             "measurement (%d + %d instructions) do not fit in the "
+             "sampling period (%d instructions).\n", name(), warmup,
+             length, period);
+
+    if (p->sample_file != "") {
+        sampleStream = simout.create(p->sample_file);
+        *sampleStream->stream() << "# sample tick insts cycles cpi\n";
+    }
+}
+
+SamplingController::~SamplingController()
+{
+    if (sampleStream)
+        simout.close(sampleStream);
+}
+
+bool
+SamplingController::active(const std::vector<BaseCPU *> &cpus)
+{
+    for (auto *cpu : cpus) {
+        if (cpu->switchedOut())
+            return false;
+    }
+    return true;
+}
+
+Counter
+SamplingController::totalInsts(const std::vector<BaseCPU *> &cpus)
+{
+    Counter total = 0;
+    for (auto *cpu : cpus)
+        total += cpu->totalInsts();
+    return total;
+}
+
+void
+SamplingController::schedulePhaseEnd(const std::vector<BaseCPU *> &cpus,
+                                     Counter insts)
+{
+    // Phases are counted in the instructions of the first thread of the
+    // first CPU, like the max_insts limits of the CPUs themselves
+    ThreadContext *tc = cpus[0]->getContext(0);
+    if (eventTC && phaseEndEvent.scheduled())
+        eventTC->descheduleInstCountEvent(&phaseEndEvent);
+    tc->scheduleInstCountEvent(&phaseEndEvent,
+                               tc->getCurrentInstCount() + insts);
+    eventTC = tc;
+}
+
+void
+SamplingController::startup()
+{
+    fatal_if(!active(functionalCpus), "%s must start on the functional "
+             "CPUs.\n", name());
+
+    phase = Phase::Functional;
+    schedulePhaseEnd(functionalCpus, period - warmup - length);
+}
+
+void
+SamplingController::drainResume()
+{
+    SimObject::drainResume();
+
+    // Only act on the switches the controller asked for, the system may
+    // also be drained for other reasons
+    if (phase == Phase::ToDetailed && active(detailedCpus)) {
+        DPRINTF(Sampling, "Detailed warm-up of %d instructions\n", warmup);
+        phase = Phase::Warmup;
+        schedulePhaseEnd(detailedCpus, warmup);
+    } else if (phase == Phase::ToFunctional && active(functionalCpus)) {
+        DPRINTF(Sampling, "Functional warming of %d instructions\n",
+                period - warmup - length);
+        phase = Phase::Functional;
+        schedulePhaseEnd(functionalCpus, period - warmup - length);
+    }
+}
+
+void
+SamplingController::phaseEnd()
+{
+    eventTC = nullptr;
+
+    switch (phase) {
+      case Phase::Functional:
+        phase = Phase::ToDetailed;
+        exitSimLoop(switchToDetailedCause);
+        break;
+
+      case Phase::Warmup:
+        DPRINTF(Sampling, "Measuring sample %d\n", numSamples);
+        phase = Phase::Measurement;
+        sampleStartTick = curTick();
+        sampleStartInsts = totalInsts(detailedCpus);
+        schedulePhaseEnd(detailedCpus, length);
+        break;
+
+      case Phase::Measurement: {
+        // Average CPI of the cores, with the insts of all of them
+        const Counter insts = totalInsts(detailedCpus) - sampleStartInsts;
+        const double cycles = double(curTick() - sampleStartTick) /
+            detailedCpus[0]->clockPeriod();
+        const double sample_cpi = cycles * detailedCpus.size() / insts;
+
+        if (sampleStream) {
+            *sampleStream->stream() << numSamples << " " << sampleStartTick
+                                    << " " << insts << " " << cycles << " "
+                                    << sample_cpi << "\n";
+        }
+        measuredInsts += insts;
+        addSample(sample_cpi);
+
+        DPRINTF(Sampling, "Sample %d: CPI %f, estimate %f +/- %f\n",
+                numSamples - 1, sample_cpi, cpiMean(), cpiError());
+
+        phase = Phase::ToFunctional;
+        const bool enough = (maxSamples && numSamples >= maxSamples) ||
+            (targetError > 0 && numSamples >= minSamples &&
+             cpiRelError() <= targetError);
+        if (enough) {
+            inform("%s: CPI %f +/- %f after %d samples\n", name(),
+                   cpiMean(), cpiError(), numSamples);
+            exitSimLoop(targetReachedCause);
+        } else {
+            exitSimLoop(switchToFunctionalCause);
+        }
+        break;
+      }
+
+      default:
+        panic("%s: unexpected end of phase %d.\n", name(), (int)phase);
+    }
+}
+
+void
+SamplingController::addSample(double sample_cpi)
+{
+    numSamples++;
+    cpiSum += sample_cpi;
+    cpiSquareSum += sample_cpi * sample_cpi;
+    samples++;
+}
+
+double
+SamplingController::cpiMean() const
+{
+    return numSamples ? cpiSum / numSamples : 0;
+}
+
+double
+SamplingController::cpiStdev() const
+{
+    if (numSamples < 2)
+        return 0;
+    const double mean = cpiMean();
+    const double variance =
+        (cpiSquareSum - numSamples * mean * mean) / (numSamples - 1);
+    return variance > 0 ? std::sqrt(variance) : 0;
+}
+
+double
+SamplingController::cpiError() const
+{
+    return numSamples ? confidenceZ * cpiStdev() / std::sqrt(numSamples) :
+                        0;
+}
+
+double
+SamplingController::cpiRelError() const
+{
+    return cpiMean() > 0 ? cpiError() / cpiMean() : 0;
+}
+
+void
+SamplingController::regStats()
+{
+    SimObject::regStats();
+
+    samples
+        .name(name() + ".samples")
+        .desc("Number of samples measured")
+        ;
+
+    measuredInsts
+        .name(name() + ".measuredInsts")
+        .desc("Number of instructions measured in samples")
+        ;
+
+    meanCpi
+        .method(this, &SamplingController::cpiMean)
+        .name(name() + ".cpi")
+        .desc("Estimated CPI, mean of the sampled CPIs")
+        .precision(6)
+        ;
+
+    stdevCpi
+        .method(this, &SamplingController::cpiStdev)
+        .name(name() + ".cpiStdev")
+        .desc("Standard deviation of the sampled CPIs")
+        .precision(6)
+        ;
+
+    errorCpi
+        .method(this, &SamplingController::cpiError)
+        .name(name() + ".cpiError")
+        .desc("Half-width of the confidence interval of the CPI")
+        .precision(6)
+        ;
+
+    relErrorCpi
+        .method(this, &SamplingController::cpiRelError)
+        .name(name() + ".cpiRelError")
+        .desc("Half-width of the confidence interval relative to the CPI")
+        .precision(6)
+        ;
+}
+
+SamplingController *
+SamplingControllerParams::create()
+{
+    return new SamplingController(this);
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_SAMPLING_CONTROLLER_HH__
+#define __CPU_SAMPLING_CONTROLLER_HH__
+
+#include <string>
+#include <vector>
+
+#include "base/output.hh"
+#include "base/statistics.hh"
+#include "cpu/base.hh"
+#include "params/SamplingController.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+/**
+ * Controller for SMARTS-style sampled simulation.
+ *
+ * Execution alternates between a fast functional CPU and a detailed
+ * CPU. Every period instructions, the workload runs for warmup
+ * instructions on the detailed CPU to warm its pipeline state, then the
+ * CPI of the next length instructions is measured as one sample. The
+ * rest of the period runs on the functional CPU, which keeps the caches
+ * warm when it accesses memory through them (e.g. AtomicSimpleCPU).
+ *
+ * Phase boundaries are instruction count events on the first thread of
+ * the first active CPU, so the controller costs nothing per instruction.
+ * At every boundary that needs a CPU switch, the simulation loop exits
+ * with one of the causes below and the configuration script switches
+ * the CPUs (see sampledSimulation() in configs/common/Simulation.py).
+ * The controller picks up the next phase when the system resumes.
+ *
+ * The samples are aggregated into a CPI estimate with a confidence
+ * interval. With a target error, the simulation stops once the
+ * confidence interval is narrow enough.
+ */
+class SamplingController : public SimObject
+{
+  public:
+    /** @{ */
+    /** Exit causes asking the script for a CPU switch or to stop */
+    static const char *const switchToDetailedCause;
+    static const char *const switchToFunctionalCause;
+    static const char *const targetReachedCause;
+    /** @} */
+
+    SamplingController(const SamplingControllerParams *p);
+    ~SamplingController();
+
+    void startup() override;
+    void drainResume() override;
+    void regStats() override;
+
+  private:
+    enum class Phase
+    {
+        /** Running on the functional CPUs */
+        Functional,
+        /** Waiting for the switch to the detailed CPUs */
+        ToDetailed,
+        /** Warming up the detailed CPUs */
+        Warmup,
+        /** Measuring a sample on the detailed CPUs */
+        Measurement,
+        /** Waiting for the switch to the functional CPUs */
+        ToFunctional,
+    };
+
+    /** Handle the end of the current phase. */
+    void phaseEnd();
+
+    /**
+     * Schedule the end of the current phase after a number of
+     * instructions on the active CPUs.
+     */
+    void schedulePhaseEnd(const std::vector<BaseCPU *> &cpus, Counter insts);
+
+    /** Whether all CPUs of a set are active. */
+    static bool active(const std::vector<BaseCPU *> &cpus);
+
+    /** Instructions committed by a set of CPUs. */
+    static Counter totalInsts(const std::vector<BaseCPU *> &cpus);
+
+    /** Record a sample and update the running estimate. */
+    void addSample(double cpi);
+
+    /** @{ */
+    /** CPI estimate over the samples so far */
+    double cpiMean() const;
+    double cpiStdev() const;
+    /** Half-width of the confidence interval of the mean */
+    double cpiError() const;
+    /** cpiError() relative to cpiMean() */
+    double cpiRelError() const;
+    /** @} */
+
+    const std::vector<BaseCPU *> functionalCpus;
+    const std::vector<BaseCPU *> detailedCpus;
+    const Counter period;
+    const Counter warmup;
+    const Counter length;
+    const double confidenceZ;
+    const double targetError;
+    const unsigned minSamples;
+    const unsigned maxSamples;
+
+    Phase phase;
+    EventFunctionWrapper phaseEndEvent;
+    /** Thread the phase end event is scheduled on, if any */
+    ThreadContext *eventTC;
+
+    /** Start of the sample being measured */
+    Tick sampleStartTick;
+    Counter sampleStartInsts;
+
+    /** @{ */
+    /** Running sums over the samples */
+    unsigned numSamples;
+    double cpiSum;
+    double cpiSquareSum;
+    /** @} */
+
+    /** Optional per-sample output */
+    OutputStream *sampleStream;
+
+    Stats::Scalar samples;
+    Stats::Scalar measuredInsts;
+    Stats::Value meanCpi;
+    Stats::Value stdevCpi;
+    Stats::Value errorCpi;
+    Stats::Value relErrorCpi;
+};
+
+#endif // __CPU_SAMPLING_CONTROLLER_HH__
@@ -59,8 +59,15 @@ class AtomicSimpleCPU(BaseSimpleCPU):
     width = Param.Int(1, "CPU width")
     simulate_data_stalls = Param.Bool(False, "Simulate dcache stall cycles")
     simulate_inst_stalls = Param.Bool(False, "Simulate icache stall cycles")
+    fetch_buffer = Param.Bool(False, "Fetch whole cache lines into a fetch "
+        "buffer and serve the following fetches from the same line without "
+        "ITB or icache accesses (for functional fast-forwarding)")
+    memory_backdoor = Param.Bool(False, "Request memory backdoors and use "
+        "them for plain loads, stores and fetches (only valid without "
+        "caches anywhere in the system, for functional fast-forwarding)")
 
-    def addSimPointProbe(self, interval):
+    def addSimPointProbe(self, interval, max_clusters=0):
         simpoint = SimPoint()
         simpoint.interval = interval
+        simpoint.max_clusters = max_clusters
         self.probeListener = simpoint
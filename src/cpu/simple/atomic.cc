@@ -41,6 +41,8 @@
 
 #include "cpu/simple/atomic.hh"
 
+#include <cstring>
+
 #include "arch/locked_mem.hh"
 #include "arch/utility.hh"
 #include "base/output.hh"
@@ -80,16 +82,27 @@ AtomicSimpleCPU::AtomicSimpleCPU(AtomicSimpleCPUParams *p)
       width(p->width), locked(false),
       simulate_data_stalls(p->simulate_data_stalls),
       simulate_inst_stalls(p->simulate_inst_stalls),
+      use_fetch_buffer(p->fetch_buffer),
+      use_backdoor(p->memory_backdoor),
       icachePort(name() + ".icache_port", this),
       dcachePort(name() + ".dcache_port", this),
+      llscPending(false),
       dcache_access(false), dcache_latency(0),
       ppCommit(nullptr)
 {
+    fatal_if(use_backdoor && (simulate_data_stalls || simulate_inst_stalls),
+             "%s: Memory backdoor accesses have no latency and can't be "
+             "used when simulating stalls.", name());
+
     _status = Idle;
     ifetch_req = std::make_shared<Request>();
     data_read_req = std::make_shared<Request>();
     data_write_req = std::make_shared<Request>();
     data_amo_req = std::make_shared<Request>();
+
+    fetchBuffer.valid = false;
+    if (use_fetch_buffer)
+        fetchBuffer.data.resize(cacheLineSize());
 }
 
 
@@ -150,6 +163,9 @@ AtomicSimpleCPU::drainResume()
     DPRINTF(SimpleCPU, "Resume\n");
     verifyMemoryMode();
 
+    // Memory may have been changed behind our back while drained
+    fetchBuffer.valid = false;
+
     assert(!threadContexts.empty());
 
     _status = BaseSimpleCPU::Idle;
@@ -274,7 +290,72 @@ AtomicSimpleCPU::suspendContext(ThreadID thread_num)
 Tick
 AtomicSimpleCPU::sendPacket(MasterPort &port, const PacketPtr &pkt)
 {
-    return port.sendAtomic(pkt);
+    if (!use_backdoor)
+        return port.sendAtomic(pkt);
+
+    BackdoorMap &backdoors =
+        &port == &icachePort ? instBackdoors : dataBackdoors;
+    if (accessBackdoor(backdoors, pkt))
+        return 0;
+
+    if (pkt->req->isLLSC())
+        llscPending = pkt->isRead();
+
+    MemBackdoorPtr backdoor = nullptr;
+    Tick latency = port.sendAtomicBackdoor(pkt, backdoor);
+    if (backdoor)
+        addBackdoor(backdoors, backdoor);
+    return latency;
+}
+
+bool
+AtomicSimpleCPU::accessBackdoor(BackdoorMap &backdoors, PacketPtr pkt)
+{
+    const bool is_read = pkt->cmd == MemCmd::ReadReq;
+    if (!is_read && (pkt->cmd != MemCmd::WriteReq || llscPending ||
+                     system->numContexts() != 1)) {
+        return false;
+    }
+
+    auto it = backdoors.contains(pkt->getAddrRange());
+    if (it == backdoors.end())
+        return false;
+
+    MemBackdoorPtr backdoor = it->second;
+    uint8_t *host_addr =
+        backdoor->ptr() + (pkt->getAddr() - backdoor->range().start());
+    if (is_read) {
+        if (!backdoor->readable())
+            return false;
+        pkt->setData(host_addr);
+    } else {
+        if (!backdoor->writeable())
+            return false;
+        pkt->writeData(host_addr);
+    }
+    pkt->makeResponse();
+    return true;
+}
+
+void
+AtomicSimpleCPU::addBackdoor(BackdoorMap &backdoors, MemBackdoorPtr backdoor)
+{
+    // The memory hands out the same backdoor for every access, only keep
+    // track of it (and ask to be told about its invalidation) once
+    if (!backdoor->ptr() ||
+        backdoors.intersects(backdoor->range()) != backdoors.end()) {
+        return;
+    }
+
+    DPRINTF(SimpleCPU, "Using memory backdoor for %s\n",
+            backdoor->range().to_string());
+    backdoors.insert(backdoor->range(), backdoor);
+    backdoor->addInvalidationCallback(
+        [&backdoors](const MemBackdoor &invalidated) {
+            auto it = backdoors.contains(invalidated.range());
+            if (it != backdoors.end() && it->second == &invalidated)
+                backdoors.erase(it);
+        });
 }
 
 Tick
@@ -302,6 +383,7 @@ AtomicSimpleCPU::AtomicCPUDPort::recvAtomicSnoop(PacketPtr pkt)
         for (auto &t_info : cpu->threadInfo) {
             TheISA::handleLockedSnoop(t_info->thread, pkt, cacheBlockMask);
         }
+        cpu->invalidateFetchBuffer(pkt->getAddr(), pkt->getSize());
     }
 
     return 0;
@@ -329,6 +411,9 @@ AtomicSimpleCPU::AtomicCPUDPort::recvFunctionalSnoop(PacketPtr pkt)
             TheISA::handleLockedSnoop(t_info->thread, pkt, cacheBlockMask);
         }
     }
+
+    if (pkt->isInvalidate() || pkt->isWrite())
+        cpu->invalidateFetchBuffer(pkt->getAddr(), pkt->getSize());
 }
 
 bool
@@ -518,6 +603,8 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size, Addr addr,
 
                     // Notify other threads on this CPU of write
                     threadSnoop(&pkt, curThread);
+
+                    invalidateFetchBuffer(req->getPaddr(), req->getSize());
                 }
                 dcache_access = true;
                 assert(!pkt.isError());
@@ -610,6 +697,7 @@ AtomicSimpleCPU::amoMem(Addr addr, uint8_t* data, unsigned size,
             dcache_latency += req->localAccessor(thread->getTC(), &pkt);
         else {
             dcache_latency += sendPacket(dcachePort, &pkt);
+            invalidateFetchBuffer(req->getPaddr(), req->getSize());
         }
 
         dcache_access = true;
@@ -654,7 +742,8 @@ AtomicSimpleCPU::tick()
         updateCycleCounters(BaseCPU::CPU_STATE_ON);
 
         if (!curStaticInst || !curStaticInst->isDelayedCommit()) {
-            checkForInterrupts();
+            if (checkForInterrupts())
+                fetchBuffer.valid = false;
             checkPcEventQueue();
         }
 
@@ -670,11 +759,16 @@ AtomicSimpleCPU::tick()
 
         bool needToFetch = !isRomMicroPC(pcState.microPC()) &&
                            !curMacroStaticInst;
+        bool bufferedFetch = false;
         if (needToFetch) {
             ifetch_req->taskId(taskId());
             setupFetchRequest(ifetch_req);
-            fault = thread->itb->translateAtomic(ifetch_req, thread->getTC(),
-                                                 BaseTLB::Execute);
+            bufferedFetch = use_fetch_buffer && readFetchBuffer();
+            if (!bufferedFetch) {
+                fault = thread->itb->translateAtomic(ifetch_req,
+                                                     thread->getTC(),
+                                                     BaseTLB::Execute);
+            }
         }
 
         if (fault == NoFault) {
@@ -682,7 +776,12 @@ AtomicSimpleCPU::tick()
             bool icache_access = false;
             dcache_access = false; // assume no dcache access
 
-            if (needToFetch) {
+            if (needToFetch && !bufferedFetch && use_fetch_buffer &&
+                !ifetch_req->isUncacheable() &&
+                !ifetch_req->isStrictlyOrdered()) {
+                icache_access = true;
+                icache_latency = fillFetchBuffer();
+            } else if (needToFetch && !bufferedFetch) {
                 // This is commented out because the decoder would act like
                 // a tiny cache otherwise. It wouldn't be flushed when needed
                 // like the I cache. It should be flushed, and when that works
@@ -750,6 +849,16 @@ AtomicSimpleCPU::tick()
             }
 
         }
+
+        // Anything that may change the translation of the buffered line,
+        // or leave the current thread's context, ends the fetch buffer.
+        if (fault != NoFault ||
+            (curStaticInst && (curStaticInst->isSerializing() ||
+                               curStaticInst->isNonSpeculative() ||
+                               curStaticInst->isSquashAfter()))) {
+            fetchBuffer.valid = false;
+        }
+
         if (fault != NoFault || !t_info.stayAtPC)
             advancePC(fault);
     }
@@ -765,6 +874,57 @@ AtomicSimpleCPU::tick()
         reschedule(tickEvent, curTick() + latency, true);
 }
 
+bool
+AtomicSimpleCPU::readFetchBuffer()
+{
+    const Addr fetch_addr = ifetch_req->getVaddr();
+    const Addr offset = fetch_addr & (cacheLineSize() - 1);
+
+    if (!fetchBuffer.valid || fetchBuffer.tid != curThread ||
+        fetchBuffer.vaddr != fetch_addr - offset) {
+        return false;
+    }
+
+    // Leave the request as the translation of the line left it, for
+    // anything looking at the fetch after it is executed
+    ifetch_req->setFlags(fetchBuffer.flags);
+    ifetch_req->setPaddr(fetchBuffer.paddr + offset);
+
+    assert(offset + sizeof(inst) <= cacheLineSize());
+    std::memcpy(&inst, &fetchBuffer.data[offset], sizeof(inst));
+    return true;
+}
+
+Tick
+AtomicSimpleCPU::fillFetchBuffer()
+{
+    const Addr offset = ifetch_req->getVaddr() & (cacheLineSize() - 1);
+    assert(offset + sizeof(inst) <= cacheLineSize());
+
+    // A line never straddles a page, so the translation of the fetch
+    // address gives the physical address of the whole line.
+    RequestPtr line_req = std::make_shared<Request>(
+        ifetch_req->getPaddr() - offset, cacheLineSize(),
+        ifetch_req->getFlags(), instMasterId());
+    line_req->setContext(ifetch_req->contextId());
+    line_req->taskId(taskId());
+
+    Packet line_pkt(line_req, MemCmd::ReadReq);
+    line_pkt.dataStatic(fetchBuffer.data.data());
+
+    Tick latency = sendPacket(icachePort, &line_pkt);
+    assert(!line_pkt.isError());
+
+    fetchBuffer.valid = true;
+    fetchBuffer.tid = curThread;
+    fetchBuffer.vaddr = ifetch_req->getVaddr() - offset;
+    fetchBuffer.paddr = ifetch_req->getPaddr() - offset;
+    fetchBuffer.flags = ifetch_req->getFlags();
+
+    std::memcpy(&inst, &fetchBuffer.data[offset], sizeof(inst));
+    return latency;
+}
+
 void
 AtomicSimpleCPU::regProbePoints()
 {
@@ -41,8 +41,10 @@
 #ifndef __CPU_SIMPLE_ATOMIC_HH__
 #define __CPU_SIMPLE_ATOMIC_HH__
 
+#include "base/addr_range_map.hh"
 #include "cpu/simple/base.hh"
 #include "cpu/simple/exec_context.hh"
+#include "mem/backdoor.hh"
 #include "mem/request.hh"
 #include "params/AtomicSimpleCPU.hh"
 #include "sim/probe/probe.hh"
@@ -64,6 +66,8 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     bool locked;
     const bool simulate_data_stalls;
     const bool simulate_inst_stalls;
+    const bool use_fetch_buffer;
+    const bool use_backdoor;
 
     // main simulation loop (one cycle)
     void tick();
@@ -103,6 +107,38 @@ class AtomicSimpleCPU : public BaseSimpleCPU
 
     virtual Tick sendPacket(MasterPort &port, const PacketPtr &pkt);
 
+    /**
+     * Backdoors handed out by the memory system for each port, used
+     * when the memory_backdoor parameter is set. The memory invalidates
+     * a backdoor (and with it the entry here) when its backing store
+     * changes.
+     */
+    typedef AddrRangeMap<MemBackdoorPtr, 1> BackdoorMap;
+    BackdoorMap instBackdoors;
+    BackdoorMap dataBackdoors;
+
+    /**
+     * Set between a load-locked and the following store-conditional
+     * while backdoors are in use. The memory tracks the reservation too,
+     * and a plain store has to reach it to clear the reservation.
+     */
+    bool llscPending;
+
+    /**
+     * Serve a packet through one of the backdoors in a map.
+     *
+     * Only plain reads and writes are candidates; anything with side
+     * effects in the memory system goes through the port.
+     * Writes additionally require this CPU to be the only context in
+     * the system, as other CPUs would otherwise miss the snoop.
+     *
+     * @return true if the packet was completed through a backdoor.
+     */
+    bool accessBackdoor(BackdoorMap &backdoors, PacketPtr pkt);
+
+    /** Remember a backdoor returned by the memory system. */
+    void addBackdoor(BackdoorMap &backdoors, MemBackdoorPtr backdoor);
+
     /**
      * An AtomicCPUPort overrides the default behaviour of the
      * recvAtomicSnoop and ignores the packet instead of panicking. It
@@ -166,6 +202,57 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     bool dcache_access;
     Tick dcache_latency;
 
+    /**
+     * A copy of the cache line the current thread is fetching from,
+     * used when the fetch_buffer parameter is set. Fetches that hit in
+     * it skip both the ITB and the icache, so the translation and the
+     * contents of the line must be known not to have changed: the
+     * buffer is dropped on faults, interrupts, serializing and
+     * non-speculative instructions (which cover page table and mode
+     * changes), and on writes to the line by this CPU or seen as
+     * snoops.
+     */
+    struct FetchBuffer
+    {
+        bool valid;
+        ThreadID tid;
+        /** Line-aligned virtual address of the buffered line. */
+        Addr vaddr;
+        /** Line-aligned physical address of the buffered line. */
+        Addr paddr;
+        /** Flags of the fetch request after its translation. */
+        Request::Flags flags;
+        std::vector<uint8_t> data;
+    };
+
+    FetchBuffer fetchBuffer;
+
+    /**
+     * Try to serve the fetch described by ifetch_req from the fetch
+     * buffer.
+     *
+     * @return true if the fetch buffer held the instruction bytes.
+     */
+    bool readFetchBuffer();
+
+    /**
+     * Fill the fetch buffer with the line holding the translated fetch
+     * request and copy the instruction bytes out of it.
+     *
+     * @return The latency of the icache access.
+     */
+    Tick fillFetchBuffer();
+
+    /** Drop the fetch buffer if it overlaps a written physical range. */
+    void
+    invalidateFetchBuffer(Addr paddr, unsigned size)
+    {
+        if (fetchBuffer.valid && paddr < fetchBuffer.paddr + cacheLineSize()
+            && fetchBuffer.paddr < paddr + size) {
+            fetchBuffer.valid = false;
+        }
+    }
+
     /** Probe Points. */
     ProbePointArg<std::pair<SimpleThread*, const StaticInstPtr>> *ppCommit;
 
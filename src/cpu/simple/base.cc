@@ -432,7 +432,7 @@ BaseSimpleCPU::wakeup(ThreadID tid)
     }
 }
 
-void
+bool
 BaseSimpleCPU::checkForInterrupts()
 {
     SimpleExecContext&t_info = *threadInfo[curThread];
@@ -447,8 +447,11 @@ BaseSimpleCPU::checkForInterrupts()
             interrupts[curThread]->updateIntrInfo(tc);
             interrupt->invoke(tc);
             thread->decoder.reset();
+            return true;
         }
     }
+
+    return false;
 }
 
 
@@ -121,7 +121,8 @@ class BaseSimpleCPU : public BaseCPU
     Status _status;
 
   public:
-    void checkForInterrupts();
+    /** Take a pending interrupt; returns true if one was taken. */
+    bool checkForInterrupts();
     void setupFetchRequest(const RequestPtr &req);
     void preExecute();
     void postExecute();
@@ -44,3 +44,15 @@ class SimPoint(ProbeListenerObject):
 
     interval = Param.UInt64(100000000, "Interval Size (insts)")
     profile_file = Param.String("simpoint.bb.gz", "BBV (output) file")
+    binary_profile = Param.Bool(False, "Write the BBVs in a compact binary "
+        "format instead of SimPoint text (see util/bbv_binary_to_text.py)")
+
+    # Clustering of the intervals at the end of the simulation, in place
+    # of running the SimPoint tool on the profile
+    max_clusters = Param.Unsigned(0, "Maximum number of SimPoints to pick "
+        "with k-means, 0 to only write the profile")
+    projection_dims = Param.Unsigned(15, "Dimensions the BBVs are randomly "
+        "projected to before clustering")
+    cluster_seed = Param.UInt64(1, "Seed of the projection and clustering")
+    simpoints_file = Param.String("simpoints", "SimPoints (output) file")
+    weights_file = Param.String("weights", "SimPoint weights (output) file")
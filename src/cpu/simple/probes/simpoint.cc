@@ -37,7 +37,11 @@
 
 #include "cpu/simple/probes/simpoint.hh"
 
+#include <algorithm>
+
+#include "base/callback.hh"
 #include "base/output.hh"
+#include "sim/sim_exit.hh"
 
 SimPoint::SimPoint(const SimPointParams *p)
     : ProbeListenerObject(p),
@@ -45,12 +49,30 @@ SimPoint::SimPoint(const SimPointParams *p)
       intervalCount(0),
       intervalDrift(0),
       simpointStream(NULL),
+      binaryProfile(p->binary_profile),
+      bbIndex(1024, invalidBB),
+      lastBB(invalidBB),
       currentBBV(0, 0),
-      currentBBVInstCount(0)
+      currentBBVInstCount(0),
+      maxClusters(p->max_clusters),
+      projectionDims(p->projection_dims),
+      projectionGen(p->cluster_seed),
+      simpointsFile(p->simpoints_file),
+      weightsFile(p->weights_file)
 {
-    simpointStream = simout.create(p->profile_file, false);
+    simpointStream = simout.create(p->profile_file, binaryProfile);
     if (!simpointStream)
         fatal("unable to open SimPoint profile_file");
+    if (binaryProfile)
+        simpointStream->stream()->write("gem5BBV1", 8);
+
+    if (maxClusters) {
+        fatal_if(!projectionDims, "SimPoint projection_dims must be "
+                 "non-zero to cluster intervals");
+        kmeans.reset(new KMeans(projectionDims, p->cluster_seed));
+        registerExitCallback(
+            new MakeCallback<SimPoint, &SimPoint::writeSimPoints>(this));
+    }
 }
 
 SimPoint::~SimPoint()
@@ -71,6 +93,51 @@ SimPoint::regProbeListeners()
                                              &SimPoint::profile));
 }
 
+uint32_t
+SimPoint::findBB(const BasicBlockRange &range, uint64_t insts)
+{
+    // Fibonacci hashing of both ends of the block
+    const size_t mask = bbIndex.size() - 1;
+    size_t idx = ((range.first ^ (range.second << 7)) *
+                  0x9E3779B97F4A7C15ULL) >> 32 & mask;
+    for (; bbIndex[idx] != invalidBB; idx = (idx + 1) & mask) {
+        const BBInfo &info = bbs[bbIndex[idx]];
+        if (info.start == range.first && info.end == range.second)
+            return bbIndex[idx];
+    }
+
+    // If a new (previously unseen) basic block is found, add it with
+    // the next unique id and record its number of insts
+    const uint32_t bb = bbs.size();
+    bbs.push_back(BBInfo{range.first, range.second, insts, 0, invalidBB});
+    bbIndex[idx] = bb;
+
+    if (kmeans) {
+        std::uniform_real_distribution<double> coordinate(-1.0, 1.0);
+        for (unsigned d = 0; d < projectionDims; d++)
+            bbProjections.push_back(coordinate(projectionGen));
+    }
+
+    if (2 * bbs.size() > bbIndex.size()) {
+        std::vector<uint32_t> old_index(2 * bbIndex.size(), invalidBB);
+        old_index.swap(bbIndex);
+        for (auto old_bb : old_index) {
+            if (old_bb == invalidBB)
+                continue;
+            // Blocks are unique, so they only need a free slot
+            const BBInfo &info = bbs[old_bb];
+            const size_t new_mask = bbIndex.size() - 1;
+            size_t new_idx = ((info.start ^ (info.end << 7)) *
+                              0x9E3779B97F4A7C15ULL) >> 32 & new_mask;
+            while (bbIndex[new_idx] != invalidBB)
+                new_idx = (new_idx + 1) & new_mask;
+            bbIndex[new_idx] = old_bb;
+        }
+    }
+
+    return bb;
+}
+
 void
 SimPoint::profile(const std::pair<SimpleThread*, StaticInstPtr>& p)
 {
@@ -90,54 +157,114 @@ SimPoint::profile(const std::pair<SimpleThread*, StaticInstPtr>& p)
     if (inst->isControl()) {
         currentBBV.second = thread->pcState().instAddr();
 
-        auto map_itr = bbMap.find(currentBBV);
-        if (map_itr == bbMap.end()){
-            // If a new (previously unseen) basic block is found,
-            // add a new unique id, record num of insts and insert into bbMap.
-            BBInfo info;
-            info.id = bbMap.size() + 1;
-            info.insts = currentBBVInstCount;
-            info.count = currentBBVInstCount;
-            bbMap.insert(std::make_pair(currentBBV, info));
-        } else {
-            // If basic block is seen before, just increment the count by the
-            // number of insts in basic block.
-            BBInfo& info = map_itr->second;
-            info.count += currentBBVInstCount;
+        // Blocks mostly follow each other in the same order, so try the
+        // block that followed the previous one last time before looking
+        // up the index
+        uint32_t bb = lastBB != invalidBB ? bbs[lastBB].next : invalidBB;
+        if (bb == invalidBB || bbs[bb].start != currentBBV.first ||
+            bbs[bb].end != currentBBV.second) {
+            bb = findBB(currentBBV, currentBBVInstCount);
+            if (lastBB != invalidBB)
+                bbs[lastBB].next = bb;
         }
+        lastBB = bb;
+
+        BBInfo &info = bbs[bb];
+        if (!info.count)
+            touchedBBs.push_back(bb);
+        info.count += currentBBVInstCount;
         currentBBVInstCount = 0;
 
         // Reached end of interval if the sum of the current inst count
         // (intervalCount) and the excessive inst count from the previous
         // interval (intervalDrift) is greater than/equal to the interval size.
         if (intervalCount + intervalDrift >= intervalSize) {
-            // summarize interval and display BBV info
-            std::vector<std::pair<uint64_t, uint64_t> > counts;
-            for (auto map_itr = bbMap.begin(); map_itr != bbMap.end();
-                    ++map_itr) {
-                BBInfo& info = map_itr->second;
-                if (info.count != 0) {
-                    counts.push_back(std::make_pair(info.id, info.count));
-                    info.count = 0;
-                }
-            }
-            std::sort(counts.begin(), counts.end());
-
-            // Print output BBV info
-            *simpointStream->stream() << "T";
-            for (auto cnt_itr = counts.begin(); cnt_itr != counts.end();
-                    ++cnt_itr) {
-                *simpointStream->stream() << ":" << cnt_itr->first
-                                << ":" << cnt_itr->second << " ";
-            }
-            *simpointStream->stream() << "\n";
-
+            endInterval();
             intervalDrift = (intervalCount + intervalDrift) - intervalSize;
             intervalCount = 0;
         }
     }
 }
 
+void
+SimPoint::writeVarint(uint64_t value)
+{
+    std::ostream &os = *simpointStream->stream();
+    while (value >= 0x80) {
+        os.put(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    os.put(static_cast<char>(value));
+}
+
+void
+SimPoint::endInterval()
+{
+    // Block indices grow with their IDs
+    std::sort(touchedBBs.begin(), touchedBBs.end());
+
+    std::ostream &os = *simpointStream->stream();
+    if (binaryProfile) {
+        writeVarint(touchedBBs.size());
+        uint64_t last_id = 0;
+        for (auto bb : touchedBBs) {
+            writeVarint(bb + 1 - last_id);
+            writeVarint(bbs[bb].count);
+            last_id = bb + 1;
+        }
+    } else {
+        // Print output BBV info
+        os << "T";
+        for (auto bb : touchedBBs)
+            os << ":" << bb + 1 << ":" << bbs[bb].count << " ";
+        os << "\n";
+    }
+
+    if (kmeans) {
+        // Project the normalised BBV
+        uint64_t total = 0;
+        for (auto bb : touchedBBs)
+            total += bbs[bb].count;
+        std::vector<double> point(projectionDims, 0.0);
+        for (auto bb : touchedBBs) {
+            const double weight = double(bbs[bb].count) / total;
+            const double *projection = &bbProjections[bb * projectionDims];
+            for (unsigned d = 0; d < projectionDims; d++)
+                point[d] += weight * projection[d];
+        }
+        kmeans->addPoint(point.data());
+    }
+
+    for (auto bb : touchedBBs)
+        bbs[bb].count = 0;
+    touchedBBs.clear();
+}
+
+void
+SimPoint::writeSimPoints()
+{
+    if (!kmeans->numPoints()) {
+        warn("%s: no complete interval to pick SimPoints from\n", name());
+        return;
+    }
+
+    kmeans->clusterBest(maxClusters);
+
+    OutputStream *simpoints = simout.create(simpointsFile);
+    OutputStream *weights = simout.create(weightsFile);
+    for (unsigned c = 0; c < kmeans->numClusters(); c++) {
+        *simpoints->stream() << kmeans->representative(c) << " " << c
+                             << "\n";
+        *weights->stream() << double(kmeans->clusterSize(c)) /
+            kmeans->numPoints() << " " << c << "\n";
+    }
+    simout.close(simpoints);
+    simout.close(weights);
+
+    inform("%s: picked %d SimPoints out of %d intervals\n", name(),
+           kmeans->numClusters(), kmeans->numPoints());
+}
+
 /** SimPoint SimObject */
 SimPoint*
 SimPointParams::create()
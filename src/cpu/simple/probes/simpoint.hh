@@ -38,8 +38,12 @@
 #ifndef __CPU_SIMPLE_PROBES_SIMPOINT_HH__
 #define __CPU_SIMPLE_PROBES_SIMPOINT_HH__
 
-#include <unordered_map>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
 
+#include "base/kmeans.hh"
 #include "base/output.hh"
 #include "cpu/simple_thread.hh"
 #include "params/SimPoint.hh"
@@ -47,28 +51,28 @@
 
 /**
  * Probe for SimPoints BBV generation
+ *
+ * The BBV of every interval is written either as text, in the format
+ * read by the SimPoint tool, or in a compact binary format: an 8-byte
+ * "gem5BBV1" magic, then per interval the LEB128 number of entries
+ * followed, for every entry, by the LEB128 difference to the previous
+ * basic block ID (IDs are increasing within an interval, starting from
+ * 0) and the LEB128 instruction count. util/bbv_binary_to_text.py turns
+ * it back into text.
+ *
+ * Optionally, the intervals are also clustered at the end of the
+ * simulation, and the chosen SimPoints and their weights are written in
+ * the format produced by the SimPoint tool. As in SimPoint, every BBV is
+ * normalised and randomly projected to a few dimensions first.
  */
 
 /**
  *  Start and end address of basic block for SimPoint profiling.
- *  This structure is used to look up the hash table of BBVs.
  *  - first: PC of first inst in basic block
  *  - second: PC of last inst in basic block
  */
 typedef std::pair<Addr, Addr> BasicBlockRange;
 
-/** Overload hash function for BasicBlockRange type */
-namespace std {
-template <>
-struct hash<BasicBlockRange>
-{
-  public:
-    size_t operator()(const BasicBlockRange &bb) const {
-        return hash<Addr>()(bb.first + bb.second);
-    }
-};
-}
-
 class SimPoint : public ProbeListenerObject
 {
   public:
@@ -86,7 +90,24 @@ class SimPoint : public ProbeListenerObject
      */
     void profile(const std::pair<SimpleThread*, StaticInstPtr>&);
 
+    /**
+     * Cluster the profiled intervals and write the SimPoints and their
+     * weights. Called at the end of the simulation.
+     */
+    void writeSimPoints();
+
   private:
+    static const uint32_t invalidBB = std::numeric_limits<uint32_t>::max();
+
+    /** Look up a basic block, adding it if it was never seen before. */
+    uint32_t findBB(const BasicBlockRange &range, uint64_t insts);
+
+    /** Write the BBV of the interval that just ended and reset it. */
+    void endInterval();
+
+    /** Write an unsigned LEB128 value to the binary profile. */
+    void writeVarint(uint64_t value);
+
     /** SimPoint profiling interval size in instructions */
     const uint64_t intervalSize;
 
@@ -96,23 +117,49 @@ class SimPoint : public ProbeListenerObject
     uint64_t intervalDrift;
     /** Pointer to SimPoint BBV output stream */
     OutputStream *simpointStream;
+    /** Write the BBVs in binary rather than text */
+    const bool binaryProfile;
 
-    /** Basic Block information */
+    /** Basic Block information, the ID of a block is its index + 1 */
     struct BBInfo {
-        /** Unique ID */
-        uint64_t id;
+        Addr start;
+        Addr end;
         /** Num of static insts in BB */
         uint64_t insts;
         /** Accumulated dynamic inst count executed by BB */
         uint64_t count;
+        /** Block that followed this one the last time it ran */
+        uint32_t next;
     };
 
-    /** Hash table containing all previously seen basic blocks */
-    std::unordered_map<BasicBlockRange, BBInfo> bbMap;
+    /** All previously seen basic blocks */
+    std::vector<BBInfo> bbs;
+    /**
+     * Open-addressing index of bbs, holding block indices or invalidBB;
+     * its size is a power of two and it is kept at most half full.
+     */
+    std::vector<uint32_t> bbIndex;
+    /** Blocks executed in the current interval */
+    std::vector<uint32_t> touchedBBs;
+    /** Last block that ended, used to predict the next one */
+    uint32_t lastBB;
+
     /** Currently executing basic block */
     BasicBlockRange currentBBV;
     /** inst count in current basic block */
     uint64_t currentBBVInstCount;
+
+    /** @{ */
+    /** Clustering of the intervals, only when enabled */
+    const unsigned maxClusters;
+    const unsigned projectionDims;
+    std::mt19937_64 projectionGen;
+    /** Random projection of every basic block, projectionDims each */
+    std::vector<double> bbProjections;
+    std::unique_ptr<KMeans> kmeans;
+    const std::string simpointsFile;
+    const std::string weightsFile;
+    /** @} */
 };
 
 #endif // __CPU_SIMPLE_PROBES_SIMPOINT_HH__
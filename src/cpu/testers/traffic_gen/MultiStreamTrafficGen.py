@@ -0,0 +1,70 @@
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.proxy import *
+from m5.objects.ClockedObject import ClockedObject
+
+class MultiStreamPattern(ScopedEnum): vals = [ 'linear', 'random' ]
+
+# The multi-stream traffic generator drives a number of independent
+# request streams, one per connected port, from a single object. Every
+# stream walks its own slice of the address range with a linear or
+# uniformly random pattern, at a fixed injection period and with a
+# bounded number of outstanding requests. It is meant for bandwidth
+# studies that would otherwise need one TrafficGen per channel. For
+# parallel simulation, the streams can be split over several
+# generators placed in different event queues.
+class MultiStreamTrafficGen(ClockedObject):
+    type = 'MultiStreamTrafficGen'
+    cxx_header = "cpu/testers/traffic_gen/multi_stream_gen.hh"
+
+    # One stream per connected port
+    port = VectorMasterPort("Ports, one per stream")
+
+    system = Param.System(Parent.any, "System this generator is part of")
+
+    pattern = Param.MultiStreamPattern('linear', "Address pattern")
+
+    start_addr = Param.Addr(0, "Start of the address range")
+    end_addr = Param.Addr("End of the address range (exclusive)")
+
+    block_size = Param.Unsigned(64, "Size of the requests in bytes")
+    period = Param.Latency('1ns', "Time between requests of a stream")
+    read_percent = Param.Percent(100, "Percentage of reads")
+
+    max_outstanding_reqs = Param.Unsigned(16,
+        "Maximum number of outstanding requests per stream")
+    data_limit = Param.Addr(0,
+        "Bytes each stream transfers before it stops, 0 for no limit")
+    exit_when_done = Param.Bool(True,
+        "Exit the simulation loop once all streams reach their data limit")
+
+    # Generators in different event queues must not share a random number
+    # generator, so each has its own. Give them different seeds to keep
+    # their random streams apart.
+    seed = Param.UInt32(0, "Seed of the generator's random addresses "
+                        "and read/write choices")
@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/testers/traffic_gen/multi_stream_gen.hh"
+
+#include <algorithm>
+
+#include "base/trace.hh"
+#include "debug/TrafficGen.hh"
+#include "params/MultiStreamTrafficGen.hh"
+#include "sim/sim_exit.hh"
+#include "sim/stats.hh"
+#include "sim/system.hh"
+
+MultiStreamTrafficGen::Stream::Stream(const std::string& name,
+                                      MultiStreamTrafficGen& gen,
+                                      unsigned stream_id)
+    : port(name, gen, stream_id),
+      sendEvent([&gen, stream_id]{ gen.sendNext(stream_id); }, name),
+      base(0), size(0), offset(0),
+      addrs(batchSize), isRead(batchSize),
+      next(batchSize), nextSendTick(0), retryPkt(nullptr), outstanding(0),
+      dataRequested(0)
+{
+}
+
+MultiStreamTrafficGen::MultiStreamTrafficGen(
+    const MultiStreamTrafficGenParams *p)
+    : ClockedObject(p),
+      system(p->system),
+      pattern(p->pattern),
+      startAddr(p->start_addr),
+      endAddr(p->end_addr),
+      blockSize(p->block_size),
+      period(p->period),
+      readPercent(p->read_percent),
+      maxOutstanding(p->max_outstanding_reqs),
+      dataLimit(p->data_limit),
+      exitWhenDone(p->exit_when_done),
+      masterID(system->getMasterId(this)),
+      rng(p->seed),
+      exitRequested(false),
+      stats(this, p->port_port_connection_count)
+{
+    const unsigned num_streams = p->port_port_connection_count;
+
+    fatal_if(blockSize == 0, "%s: The block size must not be zero.\n",
+             name());
+    fatal_if(readPercent > 100, "%s cannot have more than 100%% reads.\n",
+             name());
+    fatal_if(maxOutstanding == 0,
+             "%s: Streams need at least one outstanding request.\n", name());
+
+    // Split the range into one slice per stream, each a whole number
+    // of blocks
+    const Addr num_blocks = endAddr > startAddr ?
+        (endAddr - startAddr) / blockSize : 0;
+    fatal_if(num_streams && num_blocks < num_streams,
+             "%s: The address range is too small for %d streams.\n",
+             name(), num_streams);
+
+    for (unsigned i = 0; i < num_streams; i++) {
+        streams.emplace_back(new Stream(csprintf("%s.port[%d]", name(), i),
+                                        *this, i));
+        Stream& stream = *streams.back();
+        stream.base = startAddr + i * (num_blocks / num_streams) * blockSize;
+        stream.size = (num_blocks / num_streams) * blockSize;
+    }
+}
+
+MultiStreamTrafficGen::~MultiStreamTrafficGen()
+{
+}
+
+Port &
+MultiStreamTrafficGen::getPort(const std::string &if_name, PortID idx)
+{
+    if (if_name == "port" && idx >= 0 && idx < (PortID)streams.size()) {
+        return streams[idx]->port;
+    } else {
+        return ClockedObject::getPort(if_name, idx);
+    }
+}
+
+void
+MultiStreamTrafficGen::init()
+{
+    ClockedObject::init();
+
+    fatal_if(streams.empty(), "%s has no ports connected.\n", name());
+    fatal_if(!system->isTimingMode(),
+             "%s requires the memory system to be in timing mode.\n",
+             name());
+}
+
+void
+MultiStreamTrafficGen::startup()
+{
+    for (auto& stream : streams)
+        scheduleNext(*stream);
+}
+
+void
+MultiStreamTrafficGen::refill(Stream& stream)
+{
+    if (pattern == MultiStreamPattern::linear) {
+        const Addr base = stream.base;
+        const Addr size = stream.size;
+        const Addr offset = stream.offset;
+        Addr *addrs = stream.addrs.data();
+        for (unsigned i = 0; i < batchSize; i++) {
+            Addr pos = offset + i * blockSize;
+            addrs[i] = base + (pos >= size ? pos % size : pos);
+        }
+        stream.offset = (offset + batchSize * blockSize) % size;
+    } else {
+        const Addr num_blocks = stream.size / blockSize;
+        for (unsigned i = 0; i < batchSize; i++) {
+            stream.addrs[i] = stream.base +
+                rng.random<Addr>(0, num_blocks - 1) * blockSize;
+        }
+    }
+
+    if (readPercent == 100 || readPercent == 0) {
+        std::fill(stream.isRead.begin(), stream.isRead.end(),
+                  readPercent == 100);
+    } else {
+        for (unsigned i = 0; i < batchSize; i++)
+            stream.isRead[i] = rng.random(0u, 99u) < readPercent;
+    }
+
+    stream.next = 0;
+}
+
+void
+MultiStreamTrafficGen::scheduleNext(Stream& stream)
+{
+    if (streamDone(stream) || stream.retryPkt ||
+        stream.outstanding >= maxOutstanding ||
+        stream.sendEvent.scheduled() ||
+        drainState() != DrainState::Running) {
+        return;
+    }
+    schedule(stream.sendEvent, std::max(stream.nextSendTick, curTick()));
+}
+
+void
+MultiStreamTrafficGen::sendNext(unsigned stream_id)
+{
+    Stream& stream = *streams[stream_id];
+    assert(!stream.retryPkt && stream.outstanding < maxOutstanding);
+
+    if (stream.next == batchSize)
+        refill(stream);
+
+    const Addr addr = stream.addrs[stream.next];
+    const bool is_read = stream.isRead[stream.next];
+    stream.next++;
+
+    RequestPtr req = std::make_shared<Request>(addr, blockSize, 0, masterID);
+    req->setPC(((Addr)masterID) << 2);
+    req->setStreamId(stream_id);
+
+    PacketPtr pkt = new Packet(req, is_read ? MemCmd::ReadReq :
+                                              MemCmd::WriteReq);
+    uint8_t *pkt_data = new uint8_t[blockSize];
+    pkt->dataDynamic(pkt_data);
+    if (!is_read)
+        std::fill_n(pkt_data, blockSize, (uint8_t)masterID);
+
+    DPRINTF(TrafficGen, "Stream %d: %c to addr %x, size %d\n", stream_id,
+            is_read ? 'r' : 'w', addr, blockSize);
+
+    stream.dataRequested += blockSize;
+    stream.outstanding++;
+    stats.numPackets[stream_id]++;
+
+    if (!stream.port.sendTimingReq(pkt)) {
+        stream.retryPkt = pkt;
+        return;
+    }
+
+    stream.nextSendTick = curTick() + period;
+    scheduleNext(stream);
+    if (streamDone(stream))
+        checkDone();
+}
+
+void
+MultiStreamTrafficGen::recvReqRetry(unsigned stream_id)
+{
+    Stream& stream = *streams[stream_id];
+    assert(stream.retryPkt);
+
+    stats.numRetries[stream_id]++;
+    if (!stream.port.sendTimingReq(stream.retryPkt))
+        return;
+    stream.retryPkt = nullptr;
+
+    if (drainState() == DrainState::Draining) {
+        for (const auto& s : streams) {
+            if (s->retryPkt)
+                return;
+        }
+        signalDrainDone();
+        return;
+    }
+
+    // The request is late already, send the next one a period after
+    // the retry
+    stream.nextSendTick = curTick() + period;
+    scheduleNext(stream);
+    if (streamDone(stream))
+        checkDone();
+}
+
+bool
+MultiStreamTrafficGen::recvTimingResp(unsigned stream_id, PacketPtr pkt)
+{
+    Stream& stream = *streams[stream_id];
+    assert(stream.outstanding > 0);
+    stream.outstanding--;
+
+    const Tick latency = curTick() - pkt->req->time();
+    if (pkt->isWrite()) {
+        stats.totalWrites[stream_id]++;
+        stats.bytesWritten[stream_id] += pkt->req->getSize();
+        stats.totalWriteLatency[stream_id] += latency;
+    } else {
+        stats.totalReads[stream_id]++;
+        stats.bytesRead[stream_id] += pkt->req->getSize();
+        stats.totalReadLatency[stream_id] += latency;
+    }
+
+    delete pkt;
+
+    // Restart a stream that was throttled by its outstanding requests
+    scheduleNext(stream);
+    if (streamDone(stream))
+        checkDone();
+
+    return true;
+}
+
+void
+MultiStreamTrafficGen::checkDone()
+{
+    if (!exitWhenDone || exitRequested)
+        return;
+
+    for (const auto& stream : streams) {
+        if (!streamDone(*stream) || stream->retryPkt || stream->outstanding)
+            return;
+    }
+
+    exitRequested = true;
+    exitSimLoop(name() + " has completed all its streams.");
+}
+
+DrainState
+MultiStreamTrafficGen::drain()
+{
+    bool waiting = false;
+    for (auto& stream : streams) {
+        if (stream->sendEvent.scheduled())
+            deschedule(stream->sendEvent);
+        waiting |= stream->retryPkt != nullptr;
+    }
+
+    return waiting ? DrainState::Draining : DrainState::Drained;
+}
+
+void
+MultiStreamTrafficGen::drainResume()
+{
+    for (auto& stream : streams)
+        scheduleNext(*stream);
+}
+
+MultiStreamTrafficGen::StatGroup::StatGroup(Stats::Group *parent,
+                                            unsigned num_streams)
+    : Stats::Group(parent),
+      ADD_STAT(numPackets, "Number of packets generated"),
+      ADD_STAT(numRetries, "Number of retries"),
+      ADD_STAT(bytesRead, "Number of bytes read"),
+      ADD_STAT(bytesWritten, "Number of bytes written"),
+      ADD_STAT(totalReadLatency, "Total latency of read requests"),
+      ADD_STAT(totalWriteLatency, "Total latency of write requests"),
+      ADD_STAT(totalReads, "Total num of reads"),
+      ADD_STAT(totalWrites, "Total num of writes"),
+      ADD_STAT(avgReadLatency, "Avg latency of read requests",
+               Stats::sum(totalReadLatency) / Stats::sum(totalReads)),
+      ADD_STAT(avgWriteLatency, "Avg latency of write requests",
+               Stats::sum(totalWriteLatency) / Stats::sum(totalWrites)),
+      ADD_STAT(readBW, "Read bandwidth in bytes/s",
+               Stats::sum(bytesRead) / simSeconds),
+      ADD_STAT(writeBW, "Write bandwidth in bytes/s",
+               Stats::sum(bytesWritten) / simSeconds)
+{
+    numPackets.init(num_streams);
+    numRetries.init(num_streams);
+    bytesRead.init(num_streams);
+    bytesWritten.init(num_streams);
+    totalReadLatency.init(num_streams);
+    totalWriteLatency.init(num_streams);
+    totalReads.init(num_streams);
+    totalWrites.init(num_streams);
+}
+
+MultiStreamTrafficGen*
+MultiStreamTrafficGenParams::create()
+{
+    return new MultiStreamTrafficGen(this);
+}
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of the multi-stream traffic generator.
+ */
+
+#ifndef __CPU_TRAFFIC_GEN_MULTI_STREAM_GEN_HH__
+#define __CPU_TRAFFIC_GEN_MULTI_STREAM_GEN_HH__
+
+#include <memory>
+#include <vector>
+
+#include "base/random.hh"
+#include "base/statistics.hh"
+#include "enums/MultiStreamPattern.hh"
+#include "mem/port.hh"
+#include "sim/clocked_object.hh"
+
+class System;
+struct MultiStreamTrafficGenParams;
+
+/**
+ * The multi-stream traffic generator drives one independent request
+ * stream per connected port. Each stream covers an equal slice of the
+ * address range, walked linearly or at random, and issues a request
+ * every period as long as it has fewer than the maximum number of
+ * requests outstanding.
+ *
+ * Addresses and read/write decisions are generated a batch at a time
+ * into per-stream buffers, which keeps the per-packet work down to
+ * building and sending the packet. For linear streams the batch
+ * computation is a plain loop the compiler can vectorise.
+ *
+ * All streams of a generator share its event queue. To spread the
+ * streams over several host threads, use several generators with
+ * different event queue indices. Random patterns draw from a generator
+ * owned by each traffic generator, never from the global one, so
+ * generators in different event queues do not race on it.
+ */
+class MultiStreamTrafficGen : public ClockedObject
+{
+  private:
+
+    /** Master port specialisation for a single stream */
+    class StreamPort : public MasterPort
+    {
+      public:
+
+        StreamPort(const std::string& name, MultiStreamTrafficGen& gen,
+                   unsigned stream_id)
+            : MasterPort(name, &gen), gen(gen), streamId(stream_id)
+        { }
+
+      protected:
+
+        void recvReqRetry() override { gen.recvReqRetry(streamId); }
+
+        bool
+        recvTimingResp(PacketPtr pkt) override
+        {
+            return gen.recvTimingResp(streamId, pkt);
+        }
+
+      private:
+
+        MultiStreamTrafficGen& gen;
+
+        const unsigned streamId;
+    };
+
+    /** Number of requests generated per batch */
+    static const unsigned batchSize = 64;
+
+    /** State of a single stream */
+    struct Stream
+    {
+        Stream(const std::string& name, MultiStreamTrafficGen& gen,
+               unsigned stream_id);
+
+        StreamPort port;
+
+        /** Event to issue the next request */
+        EventFunctionWrapper sendEvent;
+
+        /** Start and size of the slice of the address range */
+        Addr base;
+        Addr size;
+
+        /** Offset of the next linear batch within the slice */
+        Addr offset;
+
+        /** Addresses and commands of the current batch */
+        std::vector<Addr> addrs;
+        std::vector<uint8_t> isRead;
+
+        /** Next request to use from the current batch */
+        unsigned next;
+
+        /** Earliest tick the next request may be sent at */
+        Tick nextSendTick;
+
+        /** Packet that was refused and is waiting for a retry */
+        PacketPtr retryPkt;
+
+        /** Number of requests waiting for their response */
+        unsigned outstanding;
+
+        /** Number of bytes requested so far */
+        Addr dataRequested;
+    };
+
+    /** Generate the next batch of requests of a stream */
+    void refill(Stream& stream);
+
+    /** Issue the next request of a stream */
+    void sendNext(unsigned stream_id);
+
+    /**
+     * Schedule the next request of a stream, unless it is done,
+     * waiting for a retry, throttled by its outstanding requests or the
+     * generator is not running (responses still arrive once drained).
+     */
+    void scheduleNext(Stream& stream);
+
+    /** Check whether a stream has reached its data limit */
+    bool
+    streamDone(const Stream& stream) const
+    {
+        return dataLimit && stream.dataRequested >= dataLimit;
+    }
+
+    /** Exit the simulation loop if all streams are done */
+    void checkDone();
+
+    void recvReqRetry(unsigned stream_id);
+
+    bool recvTimingResp(unsigned stream_id, PacketPtr pkt);
+
+    /** System used to check the memory mode */
+    System *const system;
+
+    const MultiStreamPattern pattern;
+
+    const Addr startAddr;
+    const Addr endAddr;
+    const unsigned blockSize;
+    const Tick period;
+    const unsigned readPercent;
+    const unsigned maxOutstanding;
+    const Addr dataLimit;
+    const bool exitWhenDone;
+
+    /** MasterID used in generated requests */
+    const MasterID masterID;
+
+    /** Random number generator of the random pattern and read mix */
+    Random rng;
+
+    std::vector<std::unique_ptr<Stream>> streams;
+
+    /** Set once the exit event has been requested */
+    bool exitRequested;
+
+    struct StatGroup : public Stats::Group
+    {
+        StatGroup(Stats::Group *parent, unsigned num_streams);
+
+        /** Number of packets sent, per stream */
+        Stats::Vector numPackets;
+
+        /** Number of retries, per stream */
+        Stats::Vector numRetries;
+
+        /** Number of bytes read and written, per stream */
+        Stats::Vector bytesRead;
+        Stats::Vector bytesWritten;
+
+        /** Total latency of the reads and writes, per stream */
+        Stats::Vector totalReadLatency;
+        Stats::Vector totalWriteLatency;
+
+        /** Number of reads and writes completed, per stream */
+        Stats::Vector totalReads;
+        Stats::Vector totalWrites;
+
+        /** Average latency of reads and writes over all streams */
+        Stats::Formula avgReadLatency;
+        Stats::Formula avgWriteLatency;
+
+        /** Read and write bandwidth in bytes/s over all streams */
+        Stats::Formula readBW;
+        Stats::Formula writeBW;
+    } stats;
+
+  public:
+
+    MultiStreamTrafficGen(const MultiStreamTrafficGenParams *p);
+
+    ~MultiStreamTrafficGen();
+
+    Port &getPort(const std::string &if_name,
+                  PortID idx=InvalidPortID) override;
+
+    void init() override;
+
+    void startup() override;
+
+    DrainState drain() override;
+
+    void drainResume() override;
+};
+
+#endif //__CPU_TRAFFIC_GEN_MULTI_STREAM_GEN_HH__
@@ -37,25 +37,141 @@
 
 #include "cpu/testers/traffic_gen/trace_gen.hh"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
 
 #include "base/random.hh"
 #include "base/trace.hh"
 #include "debug/TrafficGen.hh"
 #include "proto/packet.pb.h"
+#include "sim/byteswap.hh"
+
+const char TraceGen::binaryTraceMagic[8] = {
+    'g', '5', 'p', 'k', 't', 'b', 'i', 'n'
+};
+
+// The layout is shared with util/packet_trace_to_binary.py
+static_assert(sizeof(TraceGen::BinaryTraceHeader) == 32,
+              "Unexpected binary trace header layout");
+static_assert(sizeof(TraceGen::BinaryTraceRecord) == 32,
+              "Unexpected binary trace record layout");
+
+/**
+ * Number of records of a binary trace the OS is asked to read ahead
+ * at a time.
+ */
+static const uint64_t prefetchRecords = 65536;
 
 TraceGen::InputStream::InputStream(const std::string& filename)
-    : trace(filename)
+    : fileName(filename), mapping(nullptr), mappingSize(0),
+      records(nullptr), numRecords(0), nextRecord(0), prefetchRecord(0)
 {
+    char magic[sizeof(binaryTraceMagic)] = {};
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    file.read(magic, sizeof(magic));
+
+    if (file.good() &&
+        memcmp(magic, binaryTraceMagic, sizeof(magic)) == 0) {
+        file.close();
+        mapBinaryTrace();
+    } else {
+        file.close();
+        trace.reset(new ProtoInputStream(filename));
+    }
     init();
 }
 
+TraceGen::InputStream::~InputStream()
+{
+    if (mapping)
+        munmap(mapping, mappingSize);
+}
+
+void
+TraceGen::InputStream::mapBinaryTrace()
+{
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd == -1)
+        fatal("Could not open %s for reading: %s\n", fileName,
+              strerror(errno));
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == -1)
+        fatal("Could not stat %s: %s\n", fileName, strerror(errno));
+    mappingSize = file_stat.st_size;
+    fatal_if(mappingSize < sizeof(BinaryTraceHeader),
+             "Binary trace %s is truncated\n", fileName);
+
+    mapping = mmap(NULL, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        fatal("Could not map %s: %s\n", fileName, strerror(errno));
+    }
+
+    // The trace is read front to back, let the OS read ahead
+    // aggressively and drop pages behind us
+    madvise(mapping, mappingSize, MADV_SEQUENTIAL);
+
+    const BinaryTraceHeader *header =
+        static_cast<const BinaryTraceHeader *>(mapping);
+    fatal_if(letoh(header->version) != 1,
+             "Binary trace %s has unsupported version %d\n", fileName,
+             letoh(header->version));
+    fatal_if(letoh(header->recordSize) != sizeof(BinaryTraceRecord),
+             "Binary trace %s has records of %d bytes, expected %d\n",
+             fileName, letoh(header->recordSize),
+             sizeof(BinaryTraceRecord));
+
+    numRecords = letoh(header->numRecords);
+    fatal_if((mappingSize - sizeof(BinaryTraceHeader)) /
+             sizeof(BinaryTraceRecord) < numRecords,
+             "Binary trace %s is truncated\n", fileName);
+
+    records = reinterpret_cast<const BinaryTraceRecord *>(
+        static_cast<const uint8_t *>(mapping) + sizeof(BinaryTraceHeader));
+}
+
+void
+TraceGen::InputStream::prefetch()
+{
+    const uint64_t end = std::min(nextRecord + 2 * prefetchRecords,
+                                  numRecords);
+    prefetchRecord = nextRecord + prefetchRecords;
+
+    // madvise wants a page aligned start address
+    const uintptr_t page_mask = ~(uintptr_t)(sysconf(_SC_PAGESIZE) - 1);
+    uintptr_t start = (uintptr_t)&records[nextRecord] & page_mask;
+    uintptr_t stop = (uintptr_t)&records[end];
+    if (stop > start)
+        madvise((void *)start, stop - start, MADV_WILLNEED);
+}
+
 void
 TraceGen::InputStream::init()
 {
+    if (!trace) {
+        const BinaryTraceHeader *header =
+            static_cast<const BinaryTraceHeader *>(mapping);
+        if (letoh(header->tickFreq) != SimClock::Frequency) {
+            panic("Trace was recorded with a different tick frequency %d\n",
+                  letoh(header->tickFreq));
+        }
+        nextRecord = 0;
+        prefetchRecord = 0;
+        return;
+    }
+
     // Create a protobuf message for the header and read it from the stream
     ProtoMessage::PacketHeader header_msg;
-    if (!trace.read(header_msg)) {
+    if (!trace->read(header_msg)) {
         panic("Failed to read packet header from trace\n");
     } else if (header_msg.tick_freq() != SimClock::Frequency) {
         panic("Trace was recorded with a different tick frequency %d\n",
@@ -66,15 +182,31 @@ TraceGen::InputStream::init()
 void
 TraceGen::InputStream::reset()
 {
-    trace.reset();
+    if (trace)
+        trace->reset();
     init();
 }
 
 bool
 TraceGen::InputStream::read(TraceElement& element)
 {
+    if (!trace) {
+        if (nextRecord == numRecords)
+            return false;
+        if (nextRecord == prefetchRecord)
+            prefetch();
+
+        const BinaryTraceRecord &record = records[nextRecord++];
+        element.cmd = MemCmd::Command(letoh(record.cmd));
+        element.addr = letoh(record.addr);
+        element.blocksize = letoh(record.size);
+        element.tick = letoh(record.tick);
+        element.flags = letoh(record.flags);
+        return true;
+    }
+
     ProtoMessage::Packet pkt_msg;
-    if (trace.read(pkt_msg)) {
+    if (trace->read(pkt_msg)) {
         element.cmd = pkt_msg.cmd();
         element.addr = pkt_msg.addr();
         element.blocksize = pkt_msg.size();
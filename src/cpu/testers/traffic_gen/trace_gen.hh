@@ -44,6 +44,8 @@
 #ifndef __CPU_TRAFFIC_GEN_TRACE_GEN_HH__
 #define __CPU_TRAFFIC_GEN_TRACE_GEN_HH__
 
+#include <memory>
+
 #include "base/bitfield.hh"
 #include "base/intmath.hh"
 #include "base_gen.hh"
@@ -54,11 +56,18 @@
  * The trace replay generator reads a trace file and plays
  * back the transactions. The trace is offset with respect to
  * the time when the state was entered.
+ *
+ * Besides the protobuf packet traces, the generator replays traces in
+ * a fixed-width binary format, which util/packet_trace_to_binary.py
+ * converts packet traces to. Binary traces are mapped into memory and
+ * the records are used in place, avoiding the decompression and
+ * parsing of every packet. The format is detected from the start of
+ * the file.
  */
 class TraceGen : public BaseGen
 {
 
-  private:
+  public:
 
     /**
      * This struct stores a line in the trace file.
@@ -97,6 +106,36 @@ class TraceGen : public BaseGen
         }
     };
 
+    /**
+     * Header of a binary packet trace, followed by the records. All
+     * fields are little endian.
+     */
+    struct BinaryTraceHeader {
+        /** Set to binaryTraceMagic */
+        char magic[8];
+        /** Format version, currently 1 */
+        uint32_t version;
+        /** Size of a record in bytes */
+        uint32_t recordSize;
+        /** Frequency of the ticks the trace was recorded with */
+        uint64_t tickFreq;
+        /** Number of records following the header */
+        uint64_t numRecords;
+    };
+
+    /** A packet in a binary packet trace. */
+    struct BinaryTraceRecord {
+        uint64_t tick;
+        uint64_t addr;
+        uint32_t size;
+        uint32_t flags;
+        /** MemCmd::Command of the packet */
+        uint32_t cmd;
+        uint32_t reserved;
+    };
+
+    static const char binaryTraceMagic[8];
+
     /**
      * The InputStream encapsulates a trace file and the
      * internal buffers and populates TraceElements based on
@@ -107,8 +146,40 @@ class TraceGen : public BaseGen
 
       private:
 
-        /// Input file stream for the protobuf trace
-        ProtoInputStream trace;
+        /// Input file stream for the protobuf trace, if it is not binary
+        std::unique_ptr<ProtoInputStream> trace;
+
+        /// Hold on to the file name for error messages
+        const std::string fileName;
+
+        /// Mapping of a binary trace file
+        void *mapping;
+
+        /// Size of the mapping in bytes
+        size_t mappingSize;
+
+        /// Records of a binary trace, pointing into the mapping
+        const BinaryTraceRecord *records;
+
+        /// Number of records in the binary trace
+        uint64_t numRecords;
+
+        /// Index of the next record to read
+        uint64_t nextRecord;
+
+        /// Index of the record at which to prefetch the next chunk
+        uint64_t prefetchRecord;
+
+        /**
+         * Map a binary trace and check its header.
+         */
+        void mapBinaryTrace();
+
+        /**
+         * Ask the OS to start reading in the records following the
+         * next one.
+         */
+        void prefetch();
 
       public:
 
@@ -119,6 +190,8 @@ class TraceGen : public BaseGen
          */
         InputStream(const std::string& filename);
 
+        ~InputStream();
+
         /**
          * Reset the stream such that it can be played once
          * again.
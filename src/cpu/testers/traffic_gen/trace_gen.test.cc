@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Writes the same packets as a protobuf packet trace and as a binary
+ * packet trace, and reads both back with the input stream of the trace
+ * generator.
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "cpu/testers/traffic_gen/trace_gen.hh"
+#include "proto/packet.pb.h"
+#include "proto/protoio.hh"
+#include "sim/byteswap.hh"
+#include "sim/core.hh"
+
+namespace
+{
+
+typedef TraceGen::TraceElement TraceElement;
+
+/** Packets with random commands, addresses, sizes, gaps and flags. */
+std::vector<TraceElement>
+makeElements(std::size_t num_elements)
+{
+    std::mt19937_64 rng(1);
+    std::vector<TraceElement> elements(num_elements);
+    Tick tick = 0;
+    for (auto &element : elements) {
+        element.cmd = (rng() % 3) ? MemCmd::ReadReq : MemCmd::WriteReq;
+        element.addr = rng() & ((ULL(1) << 40) - 1);
+        element.blocksize = 1 << (rng() % 8);
+        tick += rng() % 10000;
+        element.tick = tick;
+        element.flags = (rng() % 4) ? 0 : Request::UNCACHEABLE;
+    }
+    return elements;
+}
+
+void
+writeProtoTrace(const std::string &filename,
+                const std::vector<TraceElement> &elements)
+{
+    ProtoOutputStream trace(filename);
+
+    ProtoMessage::PacketHeader header;
+    header.set_obj_id("trace_gen.test");
+    header.set_tick_freq(SimClock::Frequency);
+    trace.write(header);
+
+    ProtoMessage::Packet packet;
+    for (const auto &element : elements) {
+        packet.set_tick(element.tick);
+        packet.set_cmd(element.cmd.toInt());
+        packet.set_addr(element.addr);
+        packet.set_size(element.blocksize);
+        if (element.flags) {
+            packet.set_flags(element.flags);
+        } else {
+            packet.clear_flags();
+        }
+        trace.write(packet);
+    }
+}
+
+void
+writeBinaryTrace(const std::string &filename,
+                 const std::vector<TraceElement> &elements)
+{
+    std::ofstream trace(filename, std::ios::out | std::ios::binary);
+
+    TraceGen::BinaryTraceHeader header;
+    std::memcpy(header.magic, TraceGen::binaryTraceMagic,
+                sizeof(header.magic));
+    header.version = htole<uint32_t>(1);
+    header.recordSize = htole<uint32_t>(sizeof(TraceGen::BinaryTraceRecord));
+    header.tickFreq = htole<uint64_t>(SimClock::Frequency);
+    header.numRecords = htole<uint64_t>(elements.size());
+    trace.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    for (const auto &element : elements) {
+        TraceGen::BinaryTraceRecord record;
+        record.tick = htole<uint64_t>(element.tick);
+        record.addr = htole<uint64_t>(element.addr);
+        record.size = htole<uint32_t>(element.blocksize);
+        record.flags = htole<uint32_t>(element.flags);
+        record.cmd = htole<uint32_t>(element.cmd.toInt());
+        record.reserved = 0;
+        trace.write(reinterpret_cast<const char *>(&record), sizeof(record));
+    }
+}
+
+/** Name of a new temporary file, with the given suffix. */
+std::string
+tempFile(const std::string &suffix)
+{
+    std::string name = "trace-XXXXXX" + suffix;
+    std::vector<char> buffer(name.begin(), name.end());
+    buffer.push_back('\0');
+    int fd = mkstemps(buffer.data(), suffix.size());
+    EXPECT_NE(-1, fd);
+    close(fd);
+    return buffer.data();
+}
+
+/** Read a trace to its end. */
+std::vector<TraceElement>
+readTrace(TraceGen::InputStream &trace)
+{
+    std::vector<TraceElement> elements;
+    TraceElement element;
+    while (trace.read(element)) {
+        elements.push_back(element);
+    }
+    return elements;
+}
+
+void
+expectEqual(const std::vector<TraceElement> &expected,
+            const std::vector<TraceElement> &elements)
+{
+    ASSERT_EQ(expected.size(), elements.size());
+    for (std::size_t i = 0; i < expected.size(); i++) {
+        EXPECT_EQ(expected[i].cmd, elements[i].cmd);
+        EXPECT_EQ(expected[i].addr, elements[i].addr);
+        EXPECT_EQ(expected[i].blocksize, elements[i].blocksize);
+        EXPECT_EQ(expected[i].tick, elements[i].tick);
+        EXPECT_EQ(expected[i].flags, elements[i].flags);
+    }
+}
+
+} // anonymous namespace
+
+TEST(TraceGenInputStreamTest, BothFormatsMatch)
+{
+    const std::vector<TraceElement> elements = makeElements(10000);
+    const std::string proto_file = tempFile(".gz");
+    const std::string binary_file = tempFile(".bin");
+    writeProtoTrace(proto_file, elements);
+    writeBinaryTrace(binary_file, elements);
+
+    TraceGen::InputStream proto_trace(proto_file);
+    TraceGen::InputStream binary_trace(binary_file);
+    expectEqual(elements, readTrace(proto_trace));
+    expectEqual(elements, readTrace(binary_trace));
+
+    // Both play again once reset
+    proto_trace.reset();
+    binary_trace.reset();
+    expectEqual(elements, readTrace(proto_trace));
+    expectEqual(elements, readTrace(binary_trace));
+
+    unlink(proto_file.c_str());
+    unlink(binary_file.c_str());
+}
+
+TEST(TraceGenInputStreamTest, EmptyTrace)
+{
+    const std::string binary_file = tempFile(".bin");
+    writeBinaryTrace(binary_file, {});
+
+    TraceGen::InputStream binary_trace(binary_file);
+    TraceElement element;
+    EXPECT_FALSE(binary_trace.read(element));
+
+    unlink(binary_file.c_str());
+}
+
+/**
+ * Replay throughput of both formats of a trace of a million packets. Not
+ * run by default, use --gtest_also_run_disabled_tests to run it on an
+ * optimized build.
+ */
+TEST(TraceGenInputStreamTest, DISABLED_Throughput)
+{
+    const std::vector<TraceElement> elements = makeElements(1000000);
+
+    auto elements_per_second = [&](const std::string &filename) {
+        const auto start = std::chrono::steady_clock::now();
+        TraceGen::InputStream trace(filename);
+        TraceElement element;
+        uint64_t num_read = 0;
+        Addr addr_sum = 0;
+        while (trace.read(element)) {
+            addr_sum += element.addr;
+            num_read++;
+        }
+        const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        EXPECT_EQ(elements.size(), num_read);
+        EXPECT_NE(0, addr_sum);
+        return num_read / elapsed.count();
+    };
+
+    for (const char *suffix : {"", ".gz", ".bin"}) {
+        const std::string filename = tempFile(suffix);
+        if (std::string(suffix) == ".bin") {
+            writeBinaryTrace(filename, elements);
+        } else {
+            writeProtoTrace(filename, elements);
+        }
+        const double rate = elements_per_second(filename);
+        std::cout << (*suffix ? suffix : "protobuf") << ": "
+                  << rate / 1e6 << " Mpackets/s" << std::endl;
+        unlink(filename.c_str());
+    }
+}
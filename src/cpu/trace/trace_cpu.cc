@@ -359,14 +359,15 @@ TraceCPU::ElasticDataGen::readNextWindow()
     uint32_t num_read = 0;
     while (num_read != windowSize) {
 
-        // Create a new graph node
-        GraphNode* new_node = new GraphNode;
+        // Get a new graph node
+        GraphNode* new_node = depGraph.allocate();
 
         // Read the next line to get the next record. If that fails then end of
         // trace has been reached and traceComplete needs to be set in addition
         // to returning false.
         if (!trace.read(new_node)) {
             DPRINTF(TraceCPUData, "\tTrace complete!\n");
+            depGraph.release(new_node);
             traceComplete = true;
             return false;
         }
@@ -378,8 +379,8 @@ TraceCPU::ElasticDataGen::readNextWindow()
         addDepsOnParent(new_node, new_node->regDep, new_node->numRegDep);
 
         num_read++;
-        // Add to map
-        depGraph[new_node->seqNum] = new_node;
+        // Add to graph
+        depGraph.insert(new_node);
         if (new_node->numRobDep == 0 && new_node->numRegDep == 0) {
             // Source dependencies are already complete, check if resources
             // are available and issue. The execution time is approximated
@@ -405,13 +406,13 @@ TraceCPU::ElasticDataGen::addDepsOnParent(GraphNode *new_node,
         if (a_dep == 0)
             break;
         // We look up the valid dependency, i.e. the parent of this node
-        auto parent_itr = depGraph.find(a_dep);
-        if (parent_itr != depGraph.end()) {
+        GraphNode* parent = depGraph.find(a_dep);
+        if (parent) {
             // If the parent is found, it is yet to be executed. Append a
             // pointer to the new node to the dependents list of the parent
             // node.
-            parent_itr->second->dependents.push_back(new_node);
-            auto num_depts = parent_itr->second->dependents.size();
+            parent->dependents.push_back(new_node);
+            auto num_depts = parent->dependents.size();
             maxDependents = std::max<double>(num_depts, maxDependents.value());
         } else {
             // The dependency is not found in the graph. So consider
@@ -452,16 +453,14 @@ TraceCPU::ElasticDataGen::execute()
         }
     }
     // Proceed to execute from readyList
-    auto graph_itr = depGraph.begin();
     auto free_itr = readyList.begin();
     // Iterate through readyList until the next free node has its execute
     // tick later than curTick or the end of readyList is reached
     while (free_itr->execTick <= curTick() && free_itr != readyList.end()) {
 
         // Get pointer to the node to be executed
-        graph_itr = depGraph.find(free_itr->seqNum);
-        assert(graph_itr != depGraph.end());
-        GraphNode* node_ptr = graph_itr->second;
+        GraphNode* node_ptr = depGraph.find(free_itr->seqNum);
+        assert(node_ptr);
 
         // If there is a retryPkt send that else execute the load
         if (retryPkt) {
@@ -559,10 +558,8 @@ TraceCPU::ElasticDataGen::execute()
             (node_ptr->dependents).clear();
             // Update the stat for numOps simulated
             owner.updateNumOps(node_ptr->robNum);
-            // delete node
-            delete node_ptr;
-            // remove from graph
-            depGraph.erase(graph_itr);
+            // remove from graph and recycle the node
+            depGraph.erase(node_ptr);
         }
         // Point to first node to continue to next iteration of while loop
         free_itr = readyList.begin();
@@ -744,9 +741,8 @@ TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
     } else {
         // If it is a load response then release the dependents waiting on it.
         // Get pointer to the completed load
-        auto graph_itr = depGraph.find(pkt->req->getReqInstSeqNum());
-        assert(graph_itr != depGraph.end());
-        GraphNode* node_ptr = graph_itr->second;
+        GraphNode* node_ptr = depGraph.find(pkt->req->getReqInstSeqNum());
+        assert(node_ptr);
 
         // Release resources occupied by the load
         hwResource.release(node_ptr);
@@ -764,10 +760,8 @@ TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
         (node_ptr->dependents).clear();
         // Update the stat for numOps completed
         owner.updateNumOps(node_ptr->robNum);
-        // delete node
-        delete node_ptr;
-        // remove from graph
-        depGraph.erase(graph_itr);
+        // remove from graph and recycle the node
+        depGraph.erase(node_ptr);
     }
 
     if (DTRACE(TraceCPUData)) {
@@ -864,8 +858,7 @@ TraceCPU::ElasticDataGen::printReadyList() {
     }
     DPRINTF(TraceCPUData, "Printing readyList:\n");
     while (itr != readyList.end()) {
-        auto graph_itr = depGraph.find(itr->seqNum);
-        GraphNode* node_ptr M5_VAR_USED = graph_itr->second;
+        GraphNode* node_ptr M5_VAR_USED = depGraph.find(itr->seqNum);
         DPRINTFR(TraceCPUData, "\t%lld(%s), %lld\n", itr->seqNum,
             node_ptr->typeToStr(), itr->execTick);
         itr++;
@@ -1255,7 +1248,10 @@ TraceCPU::ElasticDataGen::InputStream::InputStream(
     const double time_multiplier)
     : trace(filename),
       timeMultiplier(time_multiplier),
-      microOpCount(0)
+      microOpCount(0),
+      readerDone(false),
+      stopReader(false),
+      currentIdx(0)
 {
     // Create a protobuf message for the header and read it from the stream
     ProtoMessage::InstDepRecordHeader header_msg;
@@ -1273,85 +1269,247 @@ TraceCPU::ElasticDataGen::InputStream::InputStream(
     }
 }
 
+TraceCPU::ElasticDataGen::InputStream::~InputStream()
+{
+    stopReaderThread();
+}
+
 void
 TraceCPU::ElasticDataGen::InputStream::reset()
 {
+    stopReaderThread();
     trace.reset();
+
+    // Skip the header so that the records are read from the start again
+    ProtoMessage::InstDepRecordHeader header_msg;
+    trace.read(header_msg);
 }
 
-bool
-TraceCPU::ElasticDataGen::InputStream::read(GraphNode* element)
+void
+TraceCPU::ElasticDataGen::InputStream::stopReaderThread()
+{
+    if (!readerThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(queueLock);
+        stopReader = true;
+    }
+    batchFree.notify_one();
+    readerThread.join();
+
+    stopReader = false;
+    readerDone = false;
+    fullBatches.clear();
+    currentBatch.clear();
+    currentIdx = 0;
+}
+
+void
+TraceCPU::ElasticDataGen::InputStream::readerMain()
 {
     ProtoMessage::InstDepRecord pkt_msg;
-    if (trace.read(pkt_msg)) {
-        // Required fields
-        element->seqNum = pkt_msg.seq_num();
-        element->type = pkt_msg.type();
-        // Scale the compute delay to effectively scale the Trace CPU frequency
-        element->compDelay = pkt_msg.comp_delay() * timeMultiplier;
-
-        // Repeated field robDepList
-        element->clearRobDep();
-        assert((pkt_msg.rob_dep()).size() <= element->maxRobDep);
-        for (int i = 0; i < (pkt_msg.rob_dep()).size(); i++) {
-            element->robDep[element->numRobDep] = pkt_msg.rob_dep(i);
-            element->numRobDep += 1;
+    RecordBatch batch;
+    bool end_of_trace = false;
+
+    while (!end_of_trace) {
+        {
+            // Wait for the replay to catch up, and reuse one of the
+            // batches it is done with if there is any
+            std::unique_lock<std::mutex> lock(queueLock);
+            batchFree.wait(lock, [this] {
+                return stopReader || fullBatches.size() < maxBatches;
+            });
+            if (stopReader)
+                return;
+            if (!freeBatches.empty()) {
+                batch.swap(freeBatches.back());
+                freeBatches.pop_back();
+            }
         }
 
-        // Repeated field
-        element->clearRegDep();
-        assert((pkt_msg.reg_dep()).size() <= TheISA::MaxInstSrcRegs);
-        for (int i = 0; i < (pkt_msg.reg_dep()).size(); i++) {
-            // There is a possibility that an instruction has both, a register
-            // and order dependency on an instruction. In such a case, the
-            // register dependency is omitted
-            bool duplicate = false;
-            for (int j = 0; j < element->numRobDep; j++) {
-                duplicate |= (pkt_msg.reg_dep(i) == element->robDep[j]);
-            }
-            if (!duplicate) {
-                element->regDep[element->numRegDep] = pkt_msg.reg_dep(i);
-                element->numRegDep += 1;
+        batch.clear();
+        while (batch.size() < batchSize) {
+            if (!trace.read(pkt_msg)) {
+                end_of_trace = true;
+                break;
             }
+            batch.emplace_back();
+            decode(pkt_msg, batch.back());
         }
 
-        // Optional fields
-        if (pkt_msg.has_p_addr())
-            element->physAddr = pkt_msg.p_addr();
-        else
-            element->physAddr = 0;
+        {
+            std::lock_guard<std::mutex> lock(queueLock);
+            if (!batch.empty())
+                fullBatches.push_back(std::move(batch));
+            readerDone = end_of_trace;
+        }
+        batchReady.notify_one();
+        batch = RecordBatch();
+    }
+}
 
-        if (pkt_msg.has_v_addr())
-            element->virtAddr = pkt_msg.v_addr();
-        else
-            element->virtAddr = 0;
+void
+TraceCPU::ElasticDataGen::InputStream::decode(
+    const ProtoMessage::InstDepRecord& pkt_msg, DecodedRecord& record) const
+{
+    // Required fields
+    record.seqNum = pkt_msg.seq_num();
+    record.type = pkt_msg.type();
+    // Scale the compute delay to effectively scale the Trace CPU frequency
+    record.compDelay = pkt_msg.comp_delay() * timeMultiplier;
+
+    // Repeated field robDepList
+    record.robDep.fill(0);
+    record.numRobDep = 0;
+    assert((pkt_msg.rob_dep()).size() <= GraphNode::maxRobDep);
+    for (int i = 0; i < (pkt_msg.rob_dep()).size(); i++) {
+        record.robDep[record.numRobDep] = pkt_msg.rob_dep(i);
+        record.numRobDep += 1;
+    }
 
-        if (pkt_msg.has_size())
-            element->size = pkt_msg.size();
-        else
-            element->size = 0;
+    // Repeated field
+    record.regDep.fill(0);
+    record.numRegDep = 0;
+    assert((pkt_msg.reg_dep()).size() <= TheISA::MaxInstSrcRegs);
+    for (int i = 0; i < (pkt_msg.reg_dep()).size(); i++) {
+        // There is a possibility that an instruction has both, a register
+        // and order dependency on an instruction. In such a case, the
+        // register dependency is omitted
+        bool duplicate = false;
+        for (int j = 0; j < record.numRobDep; j++) {
+            duplicate |= (pkt_msg.reg_dep(i) == record.robDep[j]);
+        }
+        if (!duplicate) {
+            record.regDep[record.numRegDep] = pkt_msg.reg_dep(i);
+            record.numRegDep += 1;
+        }
+    }
 
-        if (pkt_msg.has_flags())
-            element->flags = pkt_msg.flags();
-        else
-            element->flags = 0;
+    // Optional fields
+    record.physAddr = pkt_msg.has_p_addr() ? pkt_msg.p_addr() : 0;
+    record.virtAddr = pkt_msg.has_v_addr() ? pkt_msg.v_addr() : 0;
+    record.size = pkt_msg.has_size() ? pkt_msg.size() : 0;
+    record.flags = pkt_msg.has_flags() ? pkt_msg.flags() : 0;
+    record.pc = pkt_msg.has_pc() ? pkt_msg.pc() : 0;
+    record.weight = pkt_msg.has_weight() ? pkt_msg.weight() : 0;
+}
 
-        if (pkt_msg.has_pc())
-            element->pc = pkt_msg.pc();
-        else
-            element->pc = 0;
+bool
+TraceCPU::ElasticDataGen::InputStream::read(GraphNode* element)
+{
+    if (currentIdx == currentBatch.size()) {
+        if (!readerThread.joinable() && !readerDone) {
+            readerThread = std::thread([this] { readerMain(); });
+        }
 
-        // ROB occupancy number
-        ++microOpCount;
-        if (pkt_msg.has_weight()) {
-            microOpCount += pkt_msg.weight();
+        std::unique_lock<std::mutex> lock(queueLock);
+        // Hand the consumed batch back to the reader and wait for the next
+        freeBatches.push_back(std::move(currentBatch));
+        batchReady.wait(lock, [this] {
+            return !fullBatches.empty() || readerDone;
+        });
+        if (fullBatches.empty()) {
+            // We have reached the end of the file
+            currentBatch.clear();
+            currentIdx = 0;
+            return false;
         }
-        element->robNum = microOpCount;
-        return true;
+        currentBatch = std::move(fullBatches.front());
+        fullBatches.pop_front();
+        currentIdx = 0;
+        lock.unlock();
+        batchFree.notify_one();
     }
 
-    // We have reached the end of the file
-    return false;
+    const DecodedRecord& record = currentBatch[currentIdx++];
+    element->seqNum = record.seqNum;
+    element->type = record.type;
+    element->compDelay = record.compDelay;
+    element->robDep = record.robDep;
+    element->numRobDep = record.numRobDep;
+    element->regDep = record.regDep;
+    element->numRegDep = record.numRegDep;
+    element->physAddr = record.physAddr;
+    element->virtAddr = record.virtAddr;
+    element->size = record.size;
+    element->flags = record.flags;
+    element->pc = record.pc;
+
+    // ROB occupancy number
+    ++microOpCount;
+    microOpCount += record.weight;
+    element->robNum = microOpCount;
+    return true;
+}
+
+TraceCPU::ElasticDataGen::DepGraph::DepGraph(size_t capacity)
+    : numNodes(0)
+{
+    size_t num_slots = 64;
+    while (num_slots < 2 * capacity)
+        num_slots <<= 1;
+    slots.assign(num_slots, nullptr);
+    mask = num_slots - 1;
+}
+
+TraceCPU::ElasticDataGen::GraphNode*
+TraceCPU::ElasticDataGen::DepGraph::allocate()
+{
+    if (freeNodes.empty()) {
+        nodePool.emplace_back();
+        return &nodePool.back();
+    }
+    GraphNode* node = freeNodes.back();
+    freeNodes.pop_back();
+    return node;
+}
+
+void
+TraceCPU::ElasticDataGen::DepGraph::insert(GraphNode* node)
+{
+    while (slots[node->seqNum & mask]) {
+        assert(slots[node->seqNum & mask]->seqNum != node->seqNum);
+        grow();
+    }
+    slots[node->seqNum & mask] = node;
+    numNodes++;
+}
+
+void
+TraceCPU::ElasticDataGen::DepGraph::erase(GraphNode* node)
+{
+    assert(slots[node->seqNum & mask] == node);
+    slots[node->seqNum & mask] = nullptr;
+    numNodes--;
+    // Keep the capacity of the dependents for the next user of the node
+    node->dependents.clear();
+    freeNodes.push_back(node);
+}
+
+void
+TraceCPU::ElasticDataGen::DepGraph::grow()
+{
+    std::vector<GraphNode*> nodes;
+    for (auto node : slots) {
+        if (node)
+            nodes.push_back(node);
+    }
+
+    bool collision = true;
+    while (collision) {
+        slots.assign(slots.size() * 2, nullptr);
+        mask = slots.size() - 1;
+
+        collision = false;
+        for (auto node : nodes) {
+            if (slots[node->seqNum & mask]) {
+                collision = true;
+                break;
+            }
+            slots[node->seqNum & mask] = node;
+        }
+    }
 }
 
 bool
@@ -39,10 +39,14 @@
 #define __CPU_TRACE_TRACE_CPU_HH__
 
 #include <array>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <mutex>
 #include <queue>
 #include <set>
-#include <unordered_map>
+#include <thread>
+#include <vector>
 
 #include "arch/registers.hh"
 #include "base/statistics.hh"
@@ -114,6 +118,12 @@
  * inspect top N pending nodes where N is the issue-width. This is left for
  * future as the timing correlation looks good as it is.
  *
+ * The elastic trace is read and decoded ahead of the replay by a reader
+ * thread, which hands over batches of decoded records through a bounded
+ * queue. The nodes of the dependency graph live in an array indexed by the
+ * low bits of their sequence number, and completed nodes are recycled for
+ * the nodes read later.
+ *
  * At the start of an execution event, first we attempt to issue such pending
  * nodes by checking if appropriate resources have become available. If yes, we
  * compute the execute tick with respect to the time then. Then we proceed to
@@ -784,12 +794,48 @@ class TraceCPU : public BaseCPU
          * The InputStream encapsulates a trace file and the
          * internal buffers and populates GraphNodes based on
          * the input.
+         *
+         * The protobuf records are read and decoded by a reader thread
+         * that runs ahead of the replay. It hands batches of decoded
+         * records to the simulation thread through a bounded queue, so
+         * the lock is only taken once per batch.
          */
         class InputStream
         {
 
           private:
 
+            /**
+             * A trace record as decoded by the reader thread. This holds
+             * everything a GraphNode is populated with except for the ROB
+             * number, which depends on the weight of all the records
+             * consumed before it.
+             */
+            struct DecodedRecord
+            {
+                NodeSeqNum seqNum;
+                RecordType type;
+                uint64_t compDelay;
+                GraphNode::RobDepArray robDep;
+                uint8_t numRobDep;
+                GraphNode::RegDepArray regDep;
+                uint8_t numRegDep;
+                Addr physAddr;
+                Addr virtAddr;
+                uint32_t size;
+                Request::Flags flags;
+                Addr pc;
+                uint64_t weight;
+            };
+
+            typedef std::vector<DecodedRecord> RecordBatch;
+
+            /** Number of records the reader thread decodes per batch. */
+            static const size_t batchSize = 4096;
+
+            /** Maximum number of batches the reader thread runs ahead. */
+            static const size_t maxBatches = 8;
+
             /** Input file stream for the protobuf trace */
             ProtoInputStream trace;
 
@@ -809,6 +855,56 @@ class TraceCPU : public BaseCPU
              * trace and used to process the dependency trace
              */
             uint32_t windowSize;
+
+            /**
+             * The reader thread. It is started by the first read after the
+             * stream is opened or reset, and owns the protobuf stream
+             * until it is stopped.
+             */
+            std::thread readerThread;
+
+            /** Protects the batch queues and the reader flags. */
+            std::mutex queueLock;
+
+            /** Signalled when a batch is queued or the reader is done. */
+            std::condition_variable batchReady;
+
+            /** Signalled when a batch is consumed or the reader must stop. */
+            std::condition_variable batchFree;
+
+            /** Decoded batches waiting to be consumed, in trace order. */
+            std::deque<RecordBatch> fullBatches;
+
+            /** Consumed batches handed back to the reader for reuse. */
+            std::vector<RecordBatch> freeBatches;
+
+            /** Set by the reader thread when it reaches the end of trace. */
+            bool readerDone;
+
+            /** Set to ask the reader thread to stop. */
+            bool stopReader;
+
+            /** The batch the simulation thread is consuming. */
+            RecordBatch currentBatch;
+
+            /** Next record to consume from currentBatch. */
+            size_t currentIdx;
+
+            /** Main loop of the reader thread. */
+            void readerMain();
+
+            /** Stop the reader thread and drop what it read ahead. */
+            void stopReaderThread();
+
+            /**
+             * Decode a protobuf record.
+             *
+             * @param pkt_msg Record read from the trace
+             * @param record Decoded record to populate
+             */
+            void decode(const ProtoMessage::InstDepRecord& pkt_msg,
+                        DecodedRecord& record) const;
+
           public:
 
             /**
@@ -820,6 +916,8 @@ class TraceCPU : public BaseCPU
             InputStream(const std::string& filename,
                         const double time_multiplier);
 
+            ~InputStream();
+
             /**
              * Reset the stream such that it can be played once
              * again.
@@ -844,6 +942,65 @@ class TraceCPU : public BaseCPU
             uint64_t getMicroOpCount() const { return microOpCount; }
         };
 
+        /**
+         * The nodes of the dependency graph, looked up by sequence number.
+         *
+         * The sequence numbers of the nodes in the graph span little more
+         * than a couple of windows, so the nodes are kept in a power of two
+         * sized array indexed by the low bits of their sequence number. The
+         * array is doubled if two nodes in the graph ever map to the same
+         * slot. The nodes themselves are allocated from a pool and reused
+         * once they complete, pointers to them stay valid until then.
+         */
+        class DepGraph
+        {
+          public:
+            /**
+             * @param capacity Expected number of nodes in the graph
+             */
+            DepGraph(size_t capacity);
+
+            /**
+             * Get the node with a given sequence number.
+             *
+             * @return The node or nullptr if it is not in the graph
+             */
+            GraphNode*
+            find(NodeSeqNum seq_num) const
+            {
+                GraphNode* node = slots[seq_num & mask];
+                return node && node->seqNum == seq_num ? node : nullptr;
+            }
+
+            /** Get a node from the pool to populate and insert. */
+            GraphNode* allocate();
+
+            /** Return a node which was never inserted to the pool. */
+            void release(GraphNode* node) { freeNodes.push_back(node); }
+
+            /** Add a populated node to the graph. */
+            void insert(GraphNode* node);
+
+            /** Remove a node from the graph and return it to the pool. */
+            void erase(GraphNode* node);
+
+            size_t size() const { return numNodes; }
+
+            bool empty() const { return numNodes == 0; }
+
+          private:
+            /** Double the slot array until its nodes no longer collide. */
+            void grow();
+
+            std::vector<GraphNode*> slots;
+            NodeSeqNum mask;
+            size_t numNodes;
+
+            /** Storage for the nodes, a deque never moves its elements. */
+            std::deque<GraphNode> nodePool;
+            std::vector<GraphNode*> freeNodes;
+        };
+
         public:
         /* Constructor */
         ElasticDataGen(TraceCPU& _owner, const std::string& _name,
@@ -860,7 +1017,8 @@ class TraceCPU : public BaseCPU
               execComplete(false),
               windowSize(trace.getWindowSize()),
               hwResource(params->sizeROB, params->sizeStoreBuffer,
-                         params->sizeLoadBuffer)
+                         params->sizeLoadBuffer),
+              depGraph(2 * windowSize)
         {
             DPRINTF(TraceCPUData, "Window size in the trace is %d.\n",
                     windowSize);
@@ -1025,7 +1183,7 @@ class TraceCPU : public BaseCPU
         HardwareResource hwResource;
 
         /** Store the depGraph of GraphNodes */
-        std::unordered_map<NodeSeqNum, GraphNode*> depGraph;
+        DepGraph depGraph;
 
         /**
          * Queue of dependency-free nodes that are pending issue because
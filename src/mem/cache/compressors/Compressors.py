@@ -37,6 +37,12 @@ class BaseCacheCompressor(SimObject):
     size_threshold = Param.Unsigned(Parent.cache_line_size, "Minimum size, "
         "in bytes, in which a block must be compressed to. Otherwise it is "
         "stored in its uncompressed state")
+    memo_entries = Param.Unsigned(0, "Number of entries of the memo of "
+        "compression results, indexed by a hash of the line contents. "
+        "Lines whose contents are found in the memo reuse the previously "
+        "computed size and latencies instead of being compressed again, "
+        "so compressor-specific stats are only updated on memo misses. "
+        "Set to 0 to disable it")
 
 class BaseDictionaryCompressor(BaseCacheCompressor):
     type = 'BaseDictionaryCompressor'
@@ -35,6 +35,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <string>
 
 #include "debug/CacheComp.hh"
@@ -73,15 +74,57 @@ BaseCacheCompressor::CompressionData::getSize() const
 
 BaseCacheCompressor::BaseCacheCompressor(const Params *p)
   : SimObject(p), blkSize(p->block_size), sizeThreshold(p->size_threshold),
+    memo(p->memo_entries, MemoEntry{false, 0, Cycles(0), Cycles(0)}),
+    memoData(p->memo_entries * (blkSize / sizeof(uint64_t)), 0),
     stats(*this)
 {
     fatal_if(blkSize < sizeThreshold, "Compressed data must fit in a block");
 }
 
+std::size_t
+BaseCacheCompressor::getMemoIndex(const uint64_t* data) const
+{
+    // Mix every word of the line in, so that lines differing in any bit
+    // are spread across the memo
+    uint64_t hash = 0;
+    for (std::size_t i = 0; i < blkSize / sizeof(uint64_t); i++) {
+        hash = (hash ^ data[i]) * 0x9E3779B97F4A7C15ULL;
+        hash ^= hash >> 29;
+    }
+    return hash % memo.size();
+}
+
 void
 BaseCacheCompressor::compress(const uint64_t* data, Cycles& comp_lat,
                               Cycles& decomp_lat, std::size_t& comp_size_bits)
 {
+    // Check if these contents have been compressed before
+    MemoEntry* memo_entry = nullptr;
+    uint64_t* memo_data = nullptr;
+    if (!memo.empty()) {
+        const std::size_t index = getMemoIndex(data);
+        memo_entry = &memo[index];
+        memo_data = &memoData[index * (blkSize / sizeof(uint64_t))];
+        if (memo_entry->valid && !std::memcmp(memo_data, data, blkSize)) {
+            comp_lat = memo_entry->compLat;
+            decomp_lat = memo_entry->decompLat;
+            comp_size_bits = memo_entry->sizeBits;
+
+            // Update stats
+            stats.memoHits++;
+            stats.compressions++;
+            stats.compressionSizeBits += comp_size_bits;
+            stats.compressionSize[std::ceil(std::log2(comp_size_bits))]++;
+
+            DPRINTF(CacheComp, "Compressed cache line from %d to %d bits " \
+                    "(memoized). Compression latency: %llu, decompression " \
+                    "latency: %llu\n", blkSize*8, comp_size_bits, comp_lat,
+                    decomp_lat);
+            return;
+        }
+        stats.memoMisses++;
+    }
+
     // Apply compression
     std::unique_ptr<CompressionData> comp_data =
         compress(data, comp_lat, decomp_lat);
@@ -106,6 +149,15 @@ BaseCacheCompressor::compress(const uint64_t* data, Cycles& comp_lat,
         comp_size_bits = blkSize * 8;
     }
 
+    // Remember the result, replacing whatever the entry held
+    if (memo_entry) {
+        memo_entry->valid = true;
+        memo_entry->sizeBits = comp_size_bits;
+        memo_entry->compLat = comp_lat;
+        memo_entry->decompLat = decomp_lat;
+        std::memcpy(memo_data, data, blkSize);
+    }
+
     // Update stats
     stats.compressions++;
     stats.compressionSizeBits += comp_size_bits;
@@ -167,7 +219,13 @@ BaseCacheCompressor::BaseCacheCompressorStats::BaseCacheCompressorStats(
     avgCompressionSizeBits(this, "avg_compression_size_bits",
         "Average compression size, in bits"),
     decompressions(this, "total_decompressions",
-        "Total number of decompressions")
+        "Total number of decompressions"),
+    memoHits(this, "memo_hits",
+        "Number of compressions whose result was found in the memo"),
+    memoMisses(this, "memo_misses",
+        "Number of compressions whose result was not found in the memo"),
+    memoHitRate(this, "memo_hit_rate",
+        "Ratio of compressions whose result was found in the memo")
 {
 }
 
@@ -186,5 +244,8 @@ BaseCacheCompressor::BaseCacheCompressorStats::regStats()
 
     avgCompressionSizeBits.flags(Stats::total | Stats::nozero | Stats::nonan);
     avgCompressionSizeBits = compressionSizeBits / compressions;
+
+    memoHitRate.flags(Stats::nozero | Stats::nonan);
+    memoHitRate = memoHits / (memoHits + memoMisses);
 }
 
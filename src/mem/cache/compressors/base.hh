@@ -37,6 +37,7 @@
 #define __MEM_CACHE_COMPRESSORS_BASE_HH__
 
 #include <cstdint>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "base/types.hh"
@@ -75,6 +76,43 @@ class BaseCacheCompressor : public SimObject
      */
     const std::size_t sizeThreshold;
 
+    /**
+     * A memoized compression result. Compression is deterministic, so lines
+     * with identical contents always produce the same compressed size and
+     * latencies.
+     */
+    struct MemoEntry
+    {
+        /** Whether the entry holds a result. */
+        bool valid;
+
+        /** Compressed size, in bits. */
+        std::size_t sizeBits;
+
+        /** Compression latency. */
+        Cycles compLat;
+
+        /** Decompression latency. */
+        Cycles decompLat;
+    };
+
+    /** Direct-mapped memo of compression results. Empty if disabled. */
+    std::vector<MemoEntry> memo;
+
+    /**
+     * Contents of the lines whose results are in the memo, blkSize bytes
+     * per memo entry. Used to tell hash collisions apart from hits.
+     */
+    std::vector<uint64_t> memoData;
+
+    /**
+     * Get the memo entry index the given line contents map to.
+     *
+     * @param data The cache line.
+     * @return The index of the memo entry.
+     */
+    std::size_t getMemoIndex(const uint64_t* data) const;
+
     struct BaseCacheCompressorStats : public Stats::Group
     {
         const BaseCacheCompressor& compressor;
@@ -97,6 +135,15 @@ class BaseCacheCompressor : public SimObject
 
         /** Number of decompressions performed. */
         Stats::Scalar decompressions;
+
+        /** Number of compressions whose result was found in the memo. */
+        Stats::Scalar memoHits;
+
+        /** Number of compressions whose result was not in the memo. */
+        Stats::Scalar memoMisses;
+
+        /** Ratio of compressions served by the memo. */
+        Stats::Formula memoHitRate;
     } stats;
 
     /**
@@ -39,6 +39,7 @@
 #include <memory>
 
 #include "base/bitfield.hh"
+#include "mem/cache/compressors/base_delta_kernel.hh"
 #include "mem/cache/compressors/dictionary_compressor.hh"
 
 struct BaseDictionaryCompressorParams;
@@ -113,6 +114,18 @@ class BaseDelta : public DictionaryCompressor<BaseType>
 
     void addToDictionary(DictionaryEntry data) override;
 
+    /**
+     * Compress a line, assigning all of its values to their bases at once
+     * with BaseDeltaKernel. The patterns, and thus the compressed data and
+     * the pattern stats, are the same as when compressing the values one
+     * by one, which is still done for lines the kernel does not support.
+     *
+     * @param data Data to be compressed.
+     * @return The compressed data.
+     */
+    std::unique_ptr<BaseCacheCompressor::CompressionData>
+    compressLine(const uint64_t* data);
+
     std::unique_ptr<BaseCacheCompressor::CompressionData>
     compress(const uint64_t* data, Cycles& comp_lat,
         Cycles& decomp_lat) override;
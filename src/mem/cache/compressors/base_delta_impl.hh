@@ -41,6 +41,7 @@ template <class BaseType, std::size_t DeltaSizeBits>
 BaseDelta<BaseType, DeltaSizeBits>::BaseDelta(const Params *p)
     : DictionaryCompressor<BaseType>(p)
 {
+    this->template setPatternFactory<PatternFactory>();
 }
 
 template <class BaseType, std::size_t DeltaSizeBits>
@@ -63,13 +64,59 @@ BaseDelta<BaseType, DeltaSizeBits>::addToDictionary(DictionaryEntry data)
         DictionaryCompressor<BaseType>::numEntries++] = data;
 }
 
+template <class BaseType, std::size_t DeltaSizeBits>
+std::unique_ptr<BaseCacheCompressor::CompressionData>
+BaseDelta<BaseType, DeltaSizeBits>::compressLine(const uint64_t* data)
+{
+    typedef BaseDeltaKernel<BaseType, DeltaSizeBits> Kernel;
+    typedef typename DictionaryCompressor<BaseType>::CompData CompData;
+
+    const std::size_t num_values =
+        DictionaryCompressor<BaseType>::blkSize / sizeof(BaseType);
+    if (!Kernel::supports(num_values)) {
+        return DictionaryCompressor<BaseType>::compress(data);
+    }
+
+    const BaseType* values = reinterpret_cast<const BaseType*>(data);
+    int locations[Kernel::maxValues];
+    Kernel::match(values, num_values, locations);
+
+    std::unique_ptr<BaseCacheCompressor::CompressionData> comp_data =
+        std::unique_ptr<CompData>(new CompData());
+    CompData* const comp_data_ptr = static_cast<CompData*>(comp_data.get());
+    comp_data_ptr->entries.reserve(num_values);
+
+    // Create the patterns in order, so that the dictionary gets the same
+    // bases as when searching it for every value
+    resetDictionary();
+    for (std::size_t i = 0; i < num_values; i++) {
+        const DictionaryEntry bytes =
+            DictionaryCompressor<BaseType>::toDictionaryEntry(values[i]);
+        std::unique_ptr<typename DictionaryCompressor<BaseType>::Pattern>
+            pattern;
+        if (locations[i] < 0) {
+            pattern.reset(new PatternX(bytes, -1));
+            addToDictionary(bytes);
+        } else {
+            pattern.reset(new PatternM(bytes, locations[i]));
+        }
+        DictionaryCompressor<BaseType>::patternStats[
+            pattern->getPatternNumber()]++;
+        DPRINTF(CacheComp, "Compressed %016x to %s\n", values[i],
+            pattern->print());
+        comp_data_ptr->addEntry(std::move(pattern));
+    }
+
+    return comp_data;
+}
+
 template <class BaseType, std::size_t DeltaSizeBits>
 std::unique_ptr<BaseCacheCompressor::CompressionData>
 BaseDelta<BaseType, DeltaSizeBits>::compress(const uint64_t* data,
     Cycles& comp_lat, Cycles& decomp_lat)
 {
     std::unique_ptr<BaseCacheCompressor::CompressionData> comp_data =
-        DictionaryCompressor<BaseType>::compress(data);
+        compressLine(data);
 
     // If there are more bases than the maximum, the compressor failed.
     // Otherwise, we have to take into account all bases that have not
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Lane-parallel base search of the base-delta-immediate compressors.
+ */
+
+#ifndef __MEM_CACHE_COMPRESSORS_BASE_DELTA_KERNEL_HH__
+#define __MEM_CACHE_COMPRESSORS_BASE_DELTA_KERNEL_HH__
+
+#include <cstdint>
+#include <cstring>
+
+#include "base/bitfield.hh"
+
+/**
+ * Host vector of 16 bytes holding values of the given type. The compiler
+ * maps operations on it to the SIMD instructions of the host (e.g., SSE2
+ * or NEON), or to scalar code if there are none.
+ */
+template <class T>
+struct BaseDeltaLanes;
+
+template <>
+struct BaseDeltaLanes<uint16_t>
+{
+    typedef uint16_t Vector __attribute__((vector_size(16)));
+};
+
+template <>
+struct BaseDeltaLanes<uint32_t>
+{
+    typedef uint32_t Vector __attribute__((vector_size(16)));
+};
+
+template <>
+struct BaseDeltaLanes<uint64_t>
+{
+    typedef uint64_t Vector __attribute__((vector_size(16)));
+};
+
+/**
+ * Assigns every value of a line to a base the way the BaseDelta
+ * compressors do when they search their dictionary one value at a time:
+ * a value is encoded as a delta from the first base, in insertion order,
+ * it is close enough to, and otherwise becomes a new base. The implicit
+ * zero base is the first one.
+ *
+ * Instead of comparing each value against each base, the kernel compares
+ * a whole line against one base at a time, several values per host
+ * vector instruction, and keeps the matches as a bitmask of values. The
+ * number of passes is the number of bases, which is two for every line
+ * BDI can compress.
+ *
+ * @tparam BaseType Type of a base.
+ * @tparam DeltaSizeBits Size of a delta, in bits.
+ */
+template <class BaseType, std::size_t DeltaSizeBits>
+class BaseDeltaKernel
+{
+  private:
+    static_assert(DeltaSizeBits > 0 && DeltaSizeBits < 8 * sizeof(BaseType),
+        "Delta size must be smaller than base size");
+
+    typedef typename BaseDeltaLanes<BaseType>::Vector Vector;
+
+    /** Number of values per host vector. */
+    static constexpr std::size_t lanes = sizeof(Vector) / sizeof(BaseType);
+
+    /** Largest magnitude of a delta. */
+    static constexpr BaseType limit =
+        (BaseType(1) << (DeltaSizeBits - 1)) - 1;
+
+    /**
+     * Find the values of a line that are close enough to a base. A delta
+     * fits when it lies within [-limit, limit], that is when adding limit
+     * to it gives at most 2 * limit as an unsigned number.
+     *
+     * @param values The values of the line.
+     * @param num_values Number of values of the line.
+     * @param base The base.
+     * @param first Values before this one are known not to be needed.
+     * @return Bitmask of the values that can be encoded from the base.
+     */
+    static uint64_t
+    matchBase(const BaseType* values, std::size_t num_values, BaseType base,
+              std::size_t first = 0)
+    {
+        // Each lane holds its own bit, so that the bits of a vector can be
+        // gathered with a horizontal OR
+        Vector lane_bits;
+        for (std::size_t lane = 0; lane < lanes; lane++) {
+            lane_bits[lane] = BaseType(1) << lane;
+        }
+
+        uint64_t matches = 0;
+        for (std::size_t i = first - first % lanes; i < num_values;
+             i += lanes) {
+            Vector v;
+            std::memcpy(&v, &values[i], sizeof(v));
+            const Vector fit = reinterpret_cast<Vector>(
+                (v - base + limit) <= BaseType(2 * limit)) & lane_bits;
+            BaseType bits = 0;
+            for (std::size_t lane = 0; lane < lanes; lane++) {
+                bits |= fit[lane];
+            }
+            matches |= uint64_t(bits) << i;
+        }
+        return matches;
+    }
+
+  public:
+    /** Largest number of values of a line the kernel handles. */
+    static constexpr std::size_t maxValues = 64;
+
+    /**
+     * Whether the kernel handles lines of the given number of values.
+     * Lines must fill whole host vectors and fit in the value bitmasks.
+     */
+    static constexpr bool
+    supports(std::size_t num_values)
+    {
+        return (num_values % lanes == 0) && (num_values <= maxValues);
+    }
+
+    /**
+     * Assign each value of a line to a base.
+     *
+     * @param values The values of the line.
+     * @param num_values Number of values, supports() must hold.
+     * @param locations Filled with the index of the base each value is
+     *        encoded from, or -1 for values that become a new base.
+     * @return Number of bases, including the zero base.
+     */
+    static std::size_t
+    match(const BaseType* values, std::size_t num_values, int* locations)
+    {
+        const uint64_t all = (num_values == 64) ? ~uint64_t(0) :
+            ((uint64_t(1) << num_values) - 1);
+
+        // Values close to zero are immediates
+        uint64_t matches = matchBase(values, num_values, 0);
+        for (uint64_t m = matches; m; m &= m - 1) {
+            locations[ctz64(m)] = 0;
+        }
+        uint64_t unassigned = all & ~matches;
+
+        // The first value left becomes a base, and the values after it
+        // that are close enough to it are encoded from it. Values before
+        // it have all been assigned to older bases.
+        std::size_t num_bases = 1;
+        while (unassigned) {
+            const int first = ctz64(unassigned);
+            locations[first] = -1;
+            unassigned &= unassigned - 1;
+
+            matches = matchBase(values, num_values, values[first], first) &
+                unassigned;
+            for (uint64_t m = matches; m; m &= m - 1) {
+                locations[ctz64(m)] = num_bases;
+            }
+            unassigned &= ~matches;
+            num_bases++;
+        }
+        return num_bases;
+    }
+};
+
+#endif //__MEM_CACHE_COMPRESSORS_BASE_DELTA_KERNEL_HH__
@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "mem/cache/compressors/base_delta.hh"
+#include "mem/cache/compressors/base_delta_kernel.hh"
+#include "mem/cache/compressors/dictionary_compressor_impl.hh"
+
+namespace
+{
+
+typedef std::vector<uint64_t> Line;
+
+/**
+ * The outcome of compressing a line: the pattern chosen for each value, its
+ * location, the compressed size and the decompressed values.
+ */
+struct Result
+{
+    std::vector<int> patterns;
+    std::vector<int> locations;
+    std::size_t sizeBits = 0;
+    Line decompressed;
+};
+
+/**
+ * Compresses lines with the patterns of a BaseDelta compressor, either by
+ * searching the dictionary for every value as DictionaryCompressor does,
+ * or by assigning the values to bases with BaseDeltaKernel as
+ * BaseDelta::compressLine() does. The compressor itself is never
+ * instantiated.
+ */
+template <class BaseType, std::size_t DeltaSizeBits>
+class KernelTester : public BaseDelta<BaseType, DeltaSizeBits>
+{
+  private:
+    using Compressor = BaseDelta<BaseType, DeltaSizeBits>;
+    using Pattern = typename Compressor::Pattern;
+    using DictionaryEntry = typename Compressor::DictionaryEntry;
+    using PatternFactory = typename Compressor::PatternFactory;
+    using PatternX = typename Compressor::PatternX;
+    using PatternM = typename Compressor::PatternM;
+    using Kernel = BaseDeltaKernel<BaseType, DeltaSizeBits>;
+
+  public:
+    typedef std::vector<std::unique_ptr<Pattern>> Patterns;
+
+    /**
+     * Fill in a result from the patterns of a line, decompressing them
+     * with a fresh dictionary as DictionaryCompressor::decompress() does.
+     */
+    static Result
+    makeResult(const Patterns& patterns, std::size_t line_words)
+    {
+        Result result;
+        std::vector<DictionaryEntry> dictionary(1,
+            Compressor::toDictionaryEntry(0));
+        std::vector<BaseType> values;
+        for (const auto& pattern : patterns) {
+            result.patterns.push_back(pattern->getPatternNumber());
+            result.locations.push_back(pattern->getMatchLocation());
+            result.sizeBits += pattern->getSizeBits();
+
+            const int location = pattern->getMatchLocation();
+            const DictionaryEntry data = pattern->decompress(
+                (location < 0) ? Compressor::toDictionaryEntry(0) :
+                dictionary[location]);
+            if (pattern->shouldAllocate()) {
+                dictionary.push_back(data);
+            }
+            values.push_back(Compressor::fromDictionaryEntry(data));
+        }
+        result.decompressed.resize(line_words);
+        std::memcpy(result.decompressed.data(), values.data(),
+                    line_words * sizeof(uint64_t));
+        return result;
+    }
+
+    static Patterns
+    compressScalar(const Line& line)
+    {
+        const std::size_t num_values =
+            line.size() * sizeof(uint64_t) / sizeof(BaseType);
+        const BaseType* values =
+            reinterpret_cast<const BaseType*>(line.data());
+
+        // The dictionary starts with the zero base, as in resetDictionary()
+        Patterns patterns;
+        std::vector<DictionaryEntry> dictionary(num_values + 1,
+            Compressor::toDictionaryEntry(0));
+        std::size_t num_entries = 1;
+        for (std::size_t i = 0; i < num_values; i++) {
+            const DictionaryEntry bytes =
+                Compressor::toDictionaryEntry(values[i]);
+            std::unique_ptr<Pattern> pattern =
+                Compressor::template findPattern<PatternFactory>(
+                    bytes, dictionary, num_entries);
+            if (pattern->shouldAllocate()) {
+                dictionary[num_entries++] = bytes;
+            }
+            patterns.push_back(std::move(pattern));
+        }
+        return patterns;
+    }
+
+    static Patterns
+    compressKernel(const Line& line)
+    {
+        const std::size_t num_values =
+            line.size() * sizeof(uint64_t) / sizeof(BaseType);
+        const BaseType* values =
+            reinterpret_cast<const BaseType*>(line.data());
+
+        Patterns patterns;
+        int locations[Kernel::maxValues];
+        Kernel::match(values, num_values, locations);
+        for (std::size_t i = 0; i < num_values; i++) {
+            const DictionaryEntry bytes =
+                Compressor::toDictionaryEntry(values[i]);
+            if (locations[i] < 0) {
+                patterns.emplace_back(new PatternX(bytes, -1));
+            } else {
+                patterns.emplace_back(new PatternM(bytes, locations[i]));
+            }
+        }
+        return patterns;
+    }
+
+    static std::size_t
+    sizeBits(const Patterns& patterns)
+    {
+        std::size_t size_bits = 0;
+        for (const auto& pattern : patterns) {
+            size_bits += pattern->getSizeBits();
+        }
+        return size_bits;
+    }
+
+    static bool
+    supports(const Line& line)
+    {
+        return Kernel::supports(
+            line.size() * sizeof(uint64_t) / sizeof(BaseType));
+    }
+};
+
+/**
+ * Generate random lines, and lines BDI compresses: zeros, sign-extended
+ * small values, values close to a common base, and a mix of small values
+ * and values close to a base, of the given number of 64-bit words.
+ */
+std::vector<Line>
+testLines(std::size_t line_words)
+{
+    std::mt19937_64 rng(1);
+    std::vector<Line> lines;
+    lines.push_back(Line(line_words, 0));
+    lines.push_back(Line(line_words, ~0ULL));
+    lines.push_back(Line(line_words, 0x0123456789abcdefULL));
+    for (int n = 0; n < 200; n++) {
+        Line random_line(line_words), small_line(line_words);
+        Line base_line(line_words), mixed_line(line_words);
+        Line bases_line(line_words);
+        const uint64_t base = rng();
+        const int shift = rng() % 64;
+        for (std::size_t i = 0; i < line_words; i++) {
+            random_line[i] = rng();
+            small_line[i] = static_cast<uint64_t>(
+                static_cast<int64_t>(rng()) >> shift);
+            base_line[i] = base + (static_cast<int64_t>(rng()) >> shift);
+            mixed_line[i] = (rng() % 2) ? base_line[i] : small_line[i];
+            bases_line[i] = base * (rng() % 4) +
+                (static_cast<int64_t>(rng()) >> 56);
+        }
+        lines.push_back(random_line);
+        lines.push_back(small_line);
+        lines.push_back(base_line);
+        lines.push_back(mixed_line);
+        lines.push_back(bases_line);
+    }
+    return lines;
+}
+
+template <class Tester>
+void
+checkAgainstScalar(std::size_t line_words)
+{
+    for (const Line& line : testLines(line_words)) {
+        ASSERT_TRUE(Tester::supports(line));
+        const Result expected = Tester::makeResult(
+            Tester::compressScalar(line), line.size());
+        const Result result = Tester::makeResult(
+            Tester::compressKernel(line), line.size());
+        EXPECT_EQ(expected.patterns, result.patterns);
+        EXPECT_EQ(expected.locations, result.locations);
+        EXPECT_EQ(expected.sizeBits, result.sizeBits);
+        EXPECT_EQ(line, expected.decompressed);
+        EXPECT_EQ(line, result.decompressed);
+    }
+}
+
+template <class Tester>
+void
+checkAgainstScalar()
+{
+    // 16, 64 and 128-byte lines, the largest one the kernel supports for
+    // 16-bit bases
+    checkAgainstScalar<Tester>(2);
+    checkAgainstScalar<Tester>(8);
+    checkAgainstScalar<Tester>(16);
+}
+
+/**
+ * Time the compression of the test lines by both searches, and print the
+ * throughput of each.
+ */
+template <class Tester>
+void
+measureThroughput(const char* name)
+{
+    const std::vector<Line> lines = testLines(8);
+    const int repeats = 200;
+
+    auto lines_per_second = [&](typename Tester::Patterns (*compress)(
+                                    const Line&)) {
+        std::size_t size_bits = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int n = 0; n < repeats; n++) {
+            for (const Line& line : lines) {
+                size_bits += Tester::sizeBits(compress(line));
+            }
+        }
+        const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        // Keep the results alive
+        EXPECT_NE(size_bits, 0);
+        return repeats * lines.size() / elapsed.count();
+    };
+
+    const double scalar = lines_per_second(&Tester::compressScalar);
+    const double kernel = lines_per_second(&Tester::compressKernel);
+    std::cout << name << ": scalar " << scalar / 1e6 << " Mlines/s, "
+              << "kernel " << kernel / 1e6 << " Mlines/s, speedup "
+              << kernel / scalar << std::endl;
+}
+
+} // anonymous namespace
+
+TEST(BaseDeltaKernelTest, Base64Delta8)
+{
+    checkAgainstScalar<KernelTester<uint64_t, 8>>();
+}
+
+TEST(BaseDeltaKernelTest, Base64Delta16)
+{
+    checkAgainstScalar<KernelTester<uint64_t, 16>>();
+}
+
+TEST(BaseDeltaKernelTest, Base64Delta32)
+{
+    checkAgainstScalar<KernelTester<uint64_t, 32>>();
+}
+
+TEST(BaseDeltaKernelTest, Base32Delta8)
+{
+    checkAgainstScalar<KernelTester<uint32_t, 8>>();
+}
+
+TEST(BaseDeltaKernelTest, Base32Delta16)
+{
+    checkAgainstScalar<KernelTester<uint32_t, 16>>();
+}
+
+TEST(BaseDeltaKernelTest, Base16Delta8)
+{
+    checkAgainstScalar<KernelTester<uint16_t, 8>>();
+}
+
+/**
+ * Throughput of the searches on 64-byte lines. Not run by default, use
+ * --gtest_also_run_disabled_tests to run it on an optimized build.
+ */
+TEST(BaseDeltaKernelTest, DISABLED_Throughput)
+{
+    measureThroughput<KernelTester<uint64_t, 8>>("Base64Delta8");
+    measureThroughput<KernelTester<uint64_t, 16>>("Base64Delta16");
+    measureThroughput<KernelTester<uint64_t, 32>>("Base64Delta32");
+    measureThroughput<KernelTester<uint32_t, 8>>("Base32Delta8");
+    measureThroughput<KernelTester<uint32_t, 16>>("Base32Delta16");
+    measureThroughput<KernelTester<uint16_t, 8>>("Base16Delta8");
+}
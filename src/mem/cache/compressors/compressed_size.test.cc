@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Compresses lines through the public interface of the compressors whose
+ * patterns are private, and checks the sizes against the ones given by
+ * the pattern encodings of their papers.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "mem/cache/compressors/cpack.hh"
+#include "mem/cache/compressors/fpcd.hh"
+#include "params/CPack.hh"
+#include "params/FPCD.hh"
+
+namespace
+{
+
+/** Size of the compressed lines, in bytes. */
+const int blkSize = 64;
+
+/** Number of 32-bit values in a line. */
+const std::size_t numValues = blkSize / sizeof(uint32_t);
+
+/** Create a line whose i-th 32-bit value is value(i). */
+std::vector<uint64_t>
+makeLine(std::function<uint32_t(std::size_t)> value)
+{
+    std::vector<uint32_t> values(numValues);
+    for (std::size_t i = 0; i < numValues; i++) {
+        values[i] = value(i);
+    }
+    std::vector<uint64_t> line(blkSize / sizeof(uint64_t));
+    std::memcpy(line.data(), values.data(), blkSize);
+    return line;
+}
+
+const std::vector<uint64_t> zeroLine =
+    makeLine([](std::size_t i) { return 0; });
+const std::vector<uint64_t> repeatedLine =
+    makeLine([](std::size_t i) { return 0x12345678; });
+const std::vector<uint64_t> smallLine =
+    makeLine([](std::size_t i) { return i + 1; });
+const std::vector<uint64_t> upperLine =
+    makeLine([](std::size_t i) { return 0x12345600 | i; });
+const std::vector<uint64_t> randomLine =
+    makeLine([](std::size_t i) { return (i + 1) * 0x01020305; });
+
+/**
+ * Build a compressor of 64-byte lines from its parameters, as the
+ * configuration scripts would, and register its statistics. Like every
+ * SimObject, it lives until the end of the program.
+ */
+template <class Params>
+BaseCacheCompressor*
+makeCompressor(const std::string& name, int dictionary_size)
+{
+    Params* params = new Params();
+    params->name = name;
+    params->eventq_index = 0;
+    params->block_size = blkSize;
+    params->size_threshold = blkSize;
+    params->memo_entries = 0;
+    params->dictionary_size = dictionary_size;
+    BaseCacheCompressor* compressor = params->create();
+    compressor->regStats();
+    return compressor;
+}
+
+BaseCacheCompressor*
+cpack()
+{
+    static BaseCacheCompressor* compressor =
+        makeCompressor<CPackParams>("cpack", blkSize);
+    return compressor;
+}
+
+BaseCacheCompressor*
+fpcd()
+{
+    static BaseCacheCompressor* compressor =
+        makeCompressor<FPCDParams>("fpcd", 2);
+    return compressor;
+}
+
+/** Compress a line and return its size, in bits. */
+std::size_t
+compressedSize(BaseCacheCompressor* compressor,
+               const std::vector<uint64_t>& line)
+{
+    Cycles comp_lat, decomp_lat;
+    std::size_t size_bits;
+    compressor->compress(line.data(), comp_lat, decomp_lat, size_bits);
+    return size_bits;
+}
+
+} // anonymous namespace
+
+TEST(CPackTest, ZeroLine)
+{
+    // ZZZZ: 2-bit code
+    EXPECT_EQ(16 * 2, compressedSize(cpack(), zeroLine));
+}
+
+TEST(CPackTest, RepeatedLine)
+{
+    // XXXX: 2-bit code, 32-bit value. MMMM: 2-bit code, 4-bit index
+    EXPECT_EQ(34 + 15 * 6, compressedSize(cpack(), repeatedLine));
+}
+
+TEST(CPackTest, SmallLine)
+{
+    // ZZZX: 4-bit code, 8-bit value
+    EXPECT_EQ(16 * 12, compressedSize(cpack(), smallLine));
+}
+
+TEST(CPackTest, UpperLine)
+{
+    // MMMX: 4-bit code, 4-bit index, 8-bit value
+    EXPECT_EQ(34 + 15 * 16, compressedSize(cpack(), upperLine));
+}
+
+TEST(CPackTest, RandomLine)
+{
+    // Sixteen XXXX do not fit in the line, so it is left uncompressed
+    EXPECT_EQ(blkSize * 8, compressedSize(cpack(), randomLine));
+}
+
+TEST(CPackTest, LineOrder)
+{
+    // The dictionary is reset between lines
+    EXPECT_EQ(34 + 15 * 6, compressedSize(cpack(), repeatedLine));
+    EXPECT_EQ(34 + 15 * 16, compressedSize(cpack(), upperLine));
+    EXPECT_EQ(34 + 15 * 6, compressedSize(cpack(), repeatedLine));
+}
+
+TEST(FPCDTest, ZeroLine)
+{
+    // ZZZZ: 4-bit prefix
+    EXPECT_EQ(16 * 4, compressedSize(fpcd(), zeroLine));
+}
+
+TEST(FPCDTest, RepeatedLine)
+{
+    // XXXX: 4-bit prefix, 32-bit value. MMMM: 4-bit prefix
+    EXPECT_EQ(36 + 15 * 4, compressedSize(fpcd(), repeatedLine));
+}
+
+TEST(FPCDTest, SmallLine)
+{
+    // ZZZX: 4-bit prefix, 8-bit value
+    EXPECT_EQ(16 * 12, compressedSize(fpcd(), smallLine));
+}
+
+TEST(FPCDTest, UpperLine)
+{
+    // MMMX: 4-bit prefix, 8-bit value
+    EXPECT_EQ(36 + 15 * 12, compressedSize(fpcd(), upperLine));
+}
+
+TEST(FPCDTest, RandomLine)
+{
+    // Sixteen XXXX do not fit in the line, so it is left uncompressed
+    EXPECT_EQ(blkSize * 8, compressedSize(fpcd(), randomLine));
+}
+
+TEST(FPCDTest, LineOrder)
+{
+    // The dictionary is reset between lines
+    EXPECT_EQ(36 + 15 * 4, compressedSize(fpcd(), repeatedLine));
+    EXPECT_EQ(36 + 15 * 12, compressedSize(fpcd(), upperLine));
+    EXPECT_EQ(36 + 15 * 4, compressedSize(fpcd(), repeatedLine));
+}
@@ -38,6 +38,7 @@
 CPack::CPack(const Params *p)
     : DictionaryCompressor<uint32_t>(p)
 {
+    setPatternFactory<PatternFactory>();
 }
 
 void
@@ -158,6 +158,51 @@ class DictionaryCompressor : public BaseDictionaryCompressor
                                                     match_location);
             }
         }
+
+        /**
+         * Find the first pattern that matches the input, without
+         * instantiating it.
+         *
+         * @param bytes The bytes to be compressed.
+         * @param dict_bytes The bytes of the dictionary entry.
+         * @param match_location The index of the dictionary entry.
+         * @param index Index of the head pattern in the factory.
+         * @return The index of the matching pattern in the factory.
+         */
+        static int
+        matchPattern(const DictionaryEntry& bytes,
+            const DictionaryEntry& dict_bytes, const int match_location,
+            const int index = 0)
+        {
+            if (Head::isPattern(bytes, dict_bytes, match_location)) {
+                return index;
+            } else {
+                return Factory<Tail...>::matchPattern(bytes, dict_bytes,
+                                                      match_location,
+                                                      index + 1);
+            }
+        }
+
+        /**
+         * Instantiate the pattern at the given index of the factory.
+         *
+         * @param index The index of the pattern in the factory.
+         * @param bytes The bytes to be compressed.
+         * @param match_location The index of the dictionary entry.
+         * @return The pattern, or nullptr if the index is out of bounds.
+         */
+        static std::unique_ptr<Pattern>
+        createPattern(const int index, const DictionaryEntry& bytes,
+            const int match_location)
+        {
+            if (index == 0) {
+                return std::unique_ptr<Pattern>(
+                            new Head(bytes, match_location));
+            } else {
+                return Factory<Tail...>::createPattern(index - 1, bytes,
+                                                       match_location);
+            }
+        }
     };
 
     /**
@@ -179,6 +224,25 @@ class DictionaryCompressor : public BaseDictionaryCompressor
         {
             return std::unique_ptr<Pattern>(new Head(bytes, match_location));
         }
+
+        static int
+        matchPattern(const DictionaryEntry& bytes,
+            const DictionaryEntry& dict_bytes, const int match_location,
+            const int index = 0)
+        {
+            return index;
+        }
+
+        static std::unique_ptr<Pattern>
+        createPattern(const int index, const DictionaryEntry& bytes,
+            const int match_location)
+        {
+            if (index == 0) {
+                return std::unique_ptr<Pattern>(
+                            new Head(bytes, match_location));
+            }
+            return nullptr;
+        }
     };
 
     /** The dictionary. */
@@ -193,6 +257,53 @@ class DictionaryCompressor : public BaseDictionaryCompressor
     getPattern(const DictionaryEntry& bytes, const DictionaryEntry& dict_bytes,
         const int match_location) const = 0;
 
+    /**
+     * Size, in bits, of each pattern of a factory, indexed by its position
+     * in the factory. The size of a pattern does not depend on the data it
+     * holds, so the table is built once per factory.
+     *
+     * @tparam PatternFactory The factory of the patterns.
+     * @return The size of each pattern of the factory.
+     */
+    template <class PatternFactory>
+    static const std::vector<std::size_t>& patternSizes();
+
+    /**
+     * Find the smallest pattern that matches the input against the first
+     * entries of a dictionary. The search starts from the no-dictionary
+     * match and keeps the first smallest (pattern, location) pair, like
+     * choosing between getPattern() results would, but it only works on
+     * factory indexes, stops as soon as no smaller pattern exists, and
+     * instantiates a single pattern.
+     *
+     * @tparam PatternFactory The factory of the patterns.
+     * @param bytes The bytes to be compressed.
+     * @param dictionary The dictionary.
+     * @param num_entries Number of valid dictionary entries.
+     * @return The selected pattern.
+     */
+    template <class PatternFactory>
+    static std::unique_ptr<Pattern> findPattern(const DictionaryEntry& bytes,
+        const std::vector<DictionaryEntry>& dictionary,
+        const std::size_t num_entries);
+
+    /** Instance of findPattern() for the factory of this compressor. */
+    std::unique_ptr<Pattern> (*findPatternFunc)(const DictionaryEntry&,
+        const std::vector<DictionaryEntry>&, const std::size_t);
+
+    /**
+     * Select the factory used to compress values. Must be called by the
+     * constructor of every compressor that inherits from this class.
+     *
+     * @tparam PatternFactory The factory of the patterns.
+     */
+    template <class PatternFactory>
+    void
+    setPatternFactory()
+    {
+        findPatternFunc = &findPattern<PatternFactory>;
+    }
+
     /**
      * Compress data.
      *
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "mem/cache/compressors/base_delta.hh"
+#include "mem/cache/compressors/dictionary_compressor_impl.hh"
+#include "mem/cache/compressors/repeated_qwords.hh"
+#include "mem/cache/compressors/zero.hh"
+
+namespace
+{
+
+/** Number of 64-bit words in the tested lines. */
+const std::size_t lineWords = 8;
+
+typedef std::vector<uint64_t> Line;
+
+/**
+ * The outcome of compressing a line: the pattern chosen for each value, its
+ * location, the compressed size and the decompressed values.
+ */
+struct Result
+{
+    std::vector<int> patterns;
+    std::vector<int> locations;
+    std::size_t sizeBits = 0;
+    Line decompressed;
+};
+
+/**
+ * Exposes the pattern factory of a dictionary compressor, and compresses
+ * lines with either the factory search used before the pattern size table
+ * (instantiate the first matching pattern of every dictionary entry, keep
+ * the smallest) or findPattern(). The compressor itself is never
+ * instantiated; its dictionary is emulated as a FIFO of dictSize entries,
+ * optionally starting with a zero base as in BDI.
+ */
+template <class Compressor, class T>
+class FactoryTester : public Compressor
+{
+  private:
+    using Pattern = typename Compressor::Pattern;
+    using DictionaryEntry = typename Compressor::DictionaryEntry;
+    using PatternFactory = typename Compressor::PatternFactory;
+
+    struct Dictionary
+    {
+        std::vector<DictionaryEntry> entries;
+        std::size_t numEntries;
+
+        Dictionary(std::size_t size, bool zero_base)
+          : entries(size, Compressor::toDictionaryEntry(0)), numEntries(0)
+        {
+            if (zero_base) {
+                add(Compressor::toDictionaryEntry(0));
+            }
+        }
+
+        void
+        add(const DictionaryEntry& data)
+        {
+            if (numEntries == entries.size()) {
+                std::copy(entries.begin() + 1, entries.end(),
+                          entries.begin());
+                entries.back() = data;
+            } else {
+                entries[numEntries++] = data;
+            }
+        }
+    };
+
+    static std::unique_ptr<Pattern>
+    searchPattern(const DictionaryEntry& bytes, const Dictionary& dict)
+    {
+        std::unique_ptr<Pattern> pattern = PatternFactory::getPattern(
+            bytes, Compressor::toDictionaryEntry(0), -1);
+        for (std::size_t i = 0; i < dict.numEntries; i++) {
+            std::unique_ptr<Pattern> temp_pattern =
+                PatternFactory::getPattern(bytes, dict.entries[i], i);
+            if (temp_pattern->getSizeBits() < pattern->getSizeBits()) {
+                pattern = std::move(temp_pattern);
+            }
+        }
+        return pattern;
+    }
+
+  public:
+    static Result
+    compress(const Line& line, std::size_t dict_size, bool zero_base,
+             bool use_factory_search)
+    {
+        std::vector<T> values(line.size() * sizeof(uint64_t) / sizeof(T));
+        std::memcpy(values.data(), line.data(),
+                    line.size() * sizeof(uint64_t));
+
+        Result result;
+        std::vector<std::unique_ptr<Pattern>> patterns;
+        Dictionary dict(dict_size, zero_base);
+        for (const T value : values) {
+            const DictionaryEntry bytes = Compressor::toDictionaryEntry(value);
+            std::unique_ptr<Pattern> pattern = use_factory_search ?
+                searchPattern(bytes, dict) :
+                Compressor::template findPattern<PatternFactory>(
+                    bytes, dict.entries, dict.numEntries);
+            if (pattern->shouldAllocate()) {
+                dict.add(bytes);
+            }
+            result.patterns.push_back(pattern->getPatternNumber());
+            result.locations.push_back(pattern->getMatchLocation());
+            result.sizeBits += pattern->getSizeBits();
+            patterns.push_back(std::move(pattern));
+        }
+
+        // Decompress with a fresh dictionary, as the compressor does
+        Dictionary decomp_dict(dict_size, zero_base);
+        std::vector<T> decomp_values;
+        for (const auto& pattern : patterns) {
+            const std::size_t location = pattern->getMatchLocation();
+            const DictionaryEntry dict_bytes =
+                (location < decomp_dict.entries.size()) ?
+                decomp_dict.entries[location] :
+                Compressor::toDictionaryEntry(0);
+            const DictionaryEntry data = pattern->decompress(dict_bytes);
+            if (pattern->shouldAllocate()) {
+                decomp_dict.add(data);
+            }
+            decomp_values.push_back(Compressor::fromDictionaryEntry(data));
+        }
+        result.decompressed.resize(line.size());
+        std::memcpy(result.decompressed.data(), decomp_values.data(),
+                    line.size() * sizeof(uint64_t));
+
+        return result;
+    }
+};
+
+/**
+ * Generate random lines, and lines with the structure compressors look
+ * for: zeros, sign-extended small values, repeated values, values close to
+ * a common base and values sharing their upper bytes.
+ */
+std::vector<Line>
+testLines()
+{
+    std::mt19937_64 rng(1);
+    std::vector<Line> lines;
+    lines.push_back(Line(lineWords, 0));
+    lines.push_back(Line(lineWords, ~0ULL));
+    lines.push_back(Line(lineWords, 0x0123456789abcdefULL));
+    for (int n = 0; n < 200; n++) {
+        Line random_line(lineWords), small_line(lineWords);
+        Line base_line(lineWords), upper_line(lineWords);
+        Line sparse_line(lineWords), repeat_line(lineWords);
+        const uint64_t base = rng();
+        for (std::size_t i = 0; i < lineWords; i++) {
+            random_line[i] = rng();
+            small_line[i] = static_cast<uint64_t>(
+                static_cast<int64_t>(static_cast<int8_t>(rng())));
+            base_line[i] = base + (rng() & 0xFF) - 0x80;
+            upper_line[i] = (base & 0xFFFFFF00FFFFFF00ULL) |
+                            (rng() & 0x000000FF000000FFULL);
+            sparse_line[i] = (rng() % 4 == 0) ? rng() & 0xFFFF : 0;
+            repeat_line[i] = (rng() % 2) ? base : (base >> 32);
+        }
+        lines.push_back(random_line);
+        lines.push_back(small_line);
+        lines.push_back(base_line);
+        lines.push_back(upper_line);
+        lines.push_back(sparse_line);
+        lines.push_back(repeat_line);
+    }
+    return lines;
+}
+
+template <class Tester>
+void
+checkAgainstFactorySearch(std::size_t dict_size, bool zero_base)
+{
+    for (const Line& line : testLines()) {
+        const Result expected =
+            Tester::compress(line, dict_size, zero_base, true);
+        const Result result =
+            Tester::compress(line, dict_size, zero_base, false);
+        EXPECT_EQ(expected.patterns, result.patterns);
+        EXPECT_EQ(expected.locations, result.locations);
+        EXPECT_EQ(expected.sizeBits, result.sizeBits);
+        EXPECT_EQ(line, expected.decompressed);
+        EXPECT_EQ(line, result.decompressed);
+    }
+}
+
+} // anonymous namespace
+
+TEST(DictionaryCompressorTest, Zero)
+{
+    checkAgainstFactorySearch<
+        FactoryTester<ZeroCompressor, uint64_t>>(8, false);
+}
+
+TEST(DictionaryCompressorTest, RepeatedQwords)
+{
+    checkAgainstFactorySearch<
+        FactoryTester<RepeatedQwordsCompressor, uint64_t>>(8, false);
+}
+
+TEST(DictionaryCompressorTest, BaseDelta)
+{
+    checkAgainstFactorySearch<
+        FactoryTester<BaseDelta<uint64_t, 8>, uint64_t>>(8, true);
+    checkAgainstFactorySearch<
+        FactoryTester<BaseDelta<uint64_t, 16>, uint64_t>>(8, true);
+    checkAgainstFactorySearch<
+        FactoryTester<BaseDelta<uint64_t, 32>, uint64_t>>(8, true);
+    checkAgainstFactorySearch<
+        FactoryTester<BaseDelta<uint32_t, 8>, uint32_t>>(16, true);
+    checkAgainstFactorySearch<
+        FactoryTester<BaseDelta<uint32_t, 16>, uint32_t>>(16, true);
+    checkAgainstFactorySearch<
+        FactoryTester<BaseDelta<uint16_t, 8>, uint16_t>>(32, true);
+}
@@ -58,7 +58,7 @@ DictionaryCompressor<T>::CompData::addEntry(std::unique_ptr<Pattern> pattern)
 
 template <class T>
 DictionaryCompressor<T>::DictionaryCompressor(const Params *p)
-    : BaseDictionaryCompressor(p)
+    : BaseDictionaryCompressor(p), findPatternFunc(nullptr)
 {
     dictionary.resize(dictionarySize);
 
@@ -76,30 +76,72 @@ DictionaryCompressor<T>::resetDictionary()
     std::fill(dictionary.begin(), dictionary.end(), toDictionaryEntry(0));
 }
 
-template <typename T>
+template <class T>
+template <class PatternFactory>
+const std::vector<std::size_t>&
+DictionaryCompressor<T>::patternSizes()
+{
+    static const std::vector<std::size_t> sizes = [] {
+        std::vector<std::size_t> table;
+        std::unique_ptr<Pattern> pattern;
+        while ((pattern = PatternFactory::createPattern(table.size(),
+                toDictionaryEntry(0), 0))) {
+            table.push_back(pattern->getSizeBits());
+        }
+        return table;
+    }();
+    return sizes;
+}
+
+template <class T>
+template <class PatternFactory>
 std::unique_ptr<typename DictionaryCompressor<T>::Pattern>
-DictionaryCompressor<T>::compressValue(const T data)
+DictionaryCompressor<T>::findPattern(const DictionaryEntry& bytes,
+    const std::vector<DictionaryEntry>& dictionary,
+    const std::size_t num_entries)
 {
-    // Split data in bytes
-    const DictionaryEntry bytes = toDictionaryEntry(data);
+    const std::vector<std::size_t>& sizes = patternSizes<PatternFactory>();
+    static const std::size_t min_size =
+        *std::min_element(sizes.begin(), sizes.end());
 
     // Start as a no-match pattern. A negative match location is used so that
     // patterns that depend on the dictionary entry don't match
-    std::unique_ptr<Pattern> pattern =
-        getPattern(bytes, toDictionaryEntry(0), -1);
-
-    // Search for word on dictionary
-    for (std::size_t i = 0; i < numEntries; i++) {
+    int pattern_index =
+        PatternFactory::matchPattern(bytes, toDictionaryEntry(0), -1);
+    int match_location = -1;
+
+    // Search for word on dictionary. Only the index of the matching pattern
+    // is tracked, and the search stops as soon as no better pattern can be
+    // found, so that a single pattern is instantiated per value
+    for (std::size_t i = 0; (i < num_entries) &&
+         (sizes[pattern_index] > min_size); i++) {
         // Try matching input with possible patterns
-        std::unique_ptr<Pattern> temp_pattern =
-            getPattern(bytes, dictionary[i], i);
+        const int temp_index =
+            PatternFactory::matchPattern(bytes, dictionary[i], i);
 
         // Check if found pattern is better than previous
-        if (temp_pattern->getSizeBits() < pattern->getSizeBits()) {
-            pattern = std::move(temp_pattern);
+        if (sizes[temp_index] < sizes[pattern_index]) {
+            pattern_index = temp_index;
+            match_location = i;
         }
     }
 
+    return PatternFactory::createPattern(pattern_index, bytes,
+                                         match_location);
+}
+
+template <typename T>
+std::unique_ptr<typename DictionaryCompressor<T>::Pattern>
+DictionaryCompressor<T>::compressValue(const T data)
+{
+    // Split data in bytes
+    const DictionaryEntry bytes = toDictionaryEntry(data);
+
+    // Find the smallest matching pattern
+    assert(findPatternFunc);
+    std::unique_ptr<Pattern> pattern =
+        findPatternFunc(bytes, dictionary, numEntries);
+
     // Update stats
     patternStats[pattern->getPatternNumber()]++;
 
@@ -123,8 +165,10 @@ DictionaryCompressor<T>::compress(const uint64_t* data)
 
     // Compress every value sequentially
     CompData* const comp_data_ptr = static_cast<CompData*>(comp_data.get());
-    const std::vector<T> values((T*)data, (T*)data + blkSize / sizeof(T));
-    for (const auto& value : values) {
+    const std::size_t num_values = blkSize / sizeof(T);
+    comp_data_ptr->entries.reserve(num_values);
+    for (std::size_t i = 0; i < num_values; i++) {
+        const T value = reinterpret_cast<const T*>(data)[i];
         std::unique_ptr<Pattern> pattern = compressValue(value);
         DPRINTF(CacheComp, "Compressed %016x to %s\n", value,
             pattern->print());
@@ -166,6 +210,7 @@ DictionaryCompressor<T>::decompress(const CompressionData* comp_data,
 
     // Decompress every entry sequentially
     std::vector<T> decomp_values;
+    decomp_values.reserve(casted_comp_data->entries.size());
     for (const auto& entry : casted_comp_data->entries) {
         const T value = decompressValue(&*entry);
         decomp_values.push_back(value);
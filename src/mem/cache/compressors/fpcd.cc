@@ -38,6 +38,7 @@
 FPCD::FPCD(const Params *p)
     : DictionaryCompressor<uint32_t>(p)
 {
+    setPatternFactory<PatternFactory>();
 }
 
 void
@@ -40,6 +40,7 @@
 RepeatedQwordsCompressor::RepeatedQwordsCompressor(const Params *p)
     : DictionaryCompressor<uint64_t>(p)
 {
+    setPatternFactory<PatternFactory>();
 }
 
 void
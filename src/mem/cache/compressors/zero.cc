@@ -40,6 +40,7 @@
 ZeroCompressor::ZeroCompressor(const Params *p)
     : DictionaryCompressor<uint64_t>(p)
 {
+    setPatternFactory<PatternFactory>();
 }
 
 void
@@ -33,6 +33,8 @@
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/cache/tags/indexing_policies/base.hh"
 
+class SetAssociative;
+
 /**
  * Entry used for set-associative tables, usable with replacement policies
  */
@@ -133,6 +135,29 @@ class AssociativeSet {
     /** Vector containing the entries of the container */
     std::vector<Entry> entries;
 
+    /**
+     * Set associative view of the indexing policy, or nullptr if the
+     * provided policy does not place the ways of a set contiguously in
+     * the entries vector. When available, lookups index the flat storage
+     * directly instead of asking the indexing policy for a copy of the set.
+     */
+    const SetAssociative* flatIndexing;
+
+    /**
+     * Scratch buffer holding the replacement candidates of the last
+     * victim search. It is sized once, so finding a victim does not
+     * allocate memory.
+     */
+    ReplacementCandidates candidates;
+
+    /**
+     * Get a pointer to the first way of the set the given address maps
+     * to. Only valid when flatIndexing is set.
+     * @param addr key element
+     * @return pointer to the first entry of the set
+     */
+    Entry* getSetBase(Addr addr) const;
+
   public:
     /**
      * Public constructor
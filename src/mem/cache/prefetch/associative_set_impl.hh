@@ -31,13 +31,16 @@
 
 #include "base/intmath.hh"
 #include "mem/cache/prefetch/associative_set.hh"
+#include "mem/cache/tags/indexing_policies/set_associative.hh"
 
 template<class Entry>
 AssociativeSet<Entry>::AssociativeSet(int assoc, int num_entries,
         BaseIndexingPolicy *idx_policy, BaseReplacementPolicy *rpl_policy,
         Entry const &init_value)
   : associativity(assoc), numEntries(num_entries), indexingPolicy(idx_policy),
-    replacementPolicy(rpl_policy), entries(numEntries, init_value)
+    replacementPolicy(rpl_policy), entries(numEntries, init_value),
+    flatIndexing(dynamic_cast<SetAssociative *>(idx_policy)),
+    candidates(assoc, nullptr)
 {
     fatal_if(!isPowerOf2(num_entries), "The number of entries of an "
              "AssociativeSet<> must be a power of 2");
@@ -47,14 +50,42 @@ AssociativeSet<Entry>::AssociativeSet(int assoc, int num_entries,
         Entry* entry = &entries[entry_idx];
         indexingPolicy->setEntry(entry, entry_idx);
         entry->replacementData = replacementPolicy->instantiateEntry();
+
+        // The flat lookup relies on the ways of a set being stored next
+        // to each other, which is not the case if the associativity of
+        // the indexing policy differs from the one of the container
+        if ((entry->getSet() * associativity + entry->getWay()) != entry_idx) {
+            flatIndexing = nullptr;
+        }
     }
 }
 
+template<class Entry>
+Entry*
+AssociativeSet<Entry>::getSetBase(Addr addr) const
+{
+    const uint32_t set = flatIndexing->extractSet(addr);
+    return const_cast<Entry *>(&entries[set * associativity]);
+}
+
 template<class Entry>
 Entry*
 AssociativeSet<Entry>::findEntry(Addr addr, bool is_secure) const
 {
     Addr tag = indexingPolicy->extractTag(addr);
+
+    if (flatIndexing) {
+        Entry* set_base = getSetBase(addr);
+        for (int way = 0; way < associativity; way++) {
+            Entry* entry = &set_base[way];
+            if ((entry->getTag() == tag) && entry->isValid() &&
+                entry->isSecure() == is_secure) {
+                return entry;
+            }
+        }
+        return nullptr;
+    }
+
     const std::vector<ReplaceableEntry*> selected_entries =
         indexingPolicy->getPossibleEntries(addr);
 
@@ -80,10 +111,16 @@ Entry*
 AssociativeSet<Entry>::findVictim(Addr addr)
 {
     // Get possible entries to be victimized
-    const std::vector<ReplaceableEntry*> selected_entries =
-        indexingPolicy->getPossibleEntries(addr);
+    if (flatIndexing) {
+        Entry* set_base = getSetBase(addr);
+        for (int way = 0; way < associativity; way++) {
+            candidates[way] = &set_base[way];
+        }
+    } else {
+        candidates = indexingPolicy->getPossibleEntries(addr);
+    }
     Entry* victim = static_cast<Entry*>(replacementPolicy->getVictim(
-                            selected_entries));
+                            candidates));
     // There is only one eviction for this replacement
     invalidate(victim);
     return victim;
@@ -94,6 +131,15 @@ template<class Entry>
 std::vector<Entry *>
 AssociativeSet<Entry>::getPossibleEntries(const Addr addr) const
 {
+    if (flatIndexing) {
+        Entry* set_base = getSetBase(addr);
+        std::vector<Entry *> entries(associativity, nullptr);
+        for (int way = 0; way < associativity; way++) {
+            entries[way] = &set_base[way];
+        }
+        return entries;
+    }
+
     std::vector<ReplaceableEntry *> selected_entries =
         indexingPolicy->getPossibleEntries(addr);
     std::vector<Entry *> entries(selected_entries.size(), nullptr);
@@ -33,6 +33,7 @@
  */
 #include "mem/page_table.hh"
 
+#include <algorithm>
 #include <string>
 
 #include "base/compiler.hh"
@@ -41,31 +42,138 @@
 #include "sim/faults.hh"
 #include "sim/serialize.hh"
 
+std::atomic<uint64_t> EmulationPageTable::nextGeneration(0);
+
+EmulationPageTable::EmulationPageTable(
+        const std::string &__name, uint64_t _pid, Addr _pageSize) :
+        pageSize(_pageSize), offsetMask(mask(floorLog2(_pageSize))),
+        pageShift(floorLog2(_pageSize)),
+        numLevels((64 - pageShift - LeafBits + NodeBits - 1) / NodeBits),
+        generation(++nextGeneration),
+        _pid(_pid), _name(__name), shared(false)
+{
+    assert(isPowerOf2(pageSize));
+}
+
+EmulationPageTable::~EmulationPageTable()
+{
+    freeNode(&root, 0);
+}
+
+void
+EmulationPageTable::freeNode(Node *node, unsigned level)
+{
+    for (auto &child : node->children) {
+        if (level + 1 < numLevels) {
+            if (child.node) {
+                freeNode(child.node, level + 1);
+                delete child.node;
+            }
+        } else {
+            delete child.leaf;
+        }
+        child.node = nullptr;
+    }
+    node->used = 0;
+}
+
+EmulationPageTable::Leaf *
+EmulationPageTable::findLeaf(Addr vpn) const
+{
+    const Node *node = &root;
+    for (unsigned level = 0; level + 1 < numLevels; level++) {
+        node = node->children[nodeIndex(vpn, level)].node;
+        if (!node)
+            return nullptr;
+    }
+    return node->children[nodeIndex(vpn, numLevels - 1)].leaf;
+}
+
+EmulationPageTable::Leaf *
+EmulationPageTable::getLeaf(Addr vpn)
+{
+    Node *node = &root;
+    for (unsigned level = 0; level + 1 < numLevels; level++) {
+        Child &child = node->children[nodeIndex(vpn, level)];
+        if (!child.node) {
+            child.node = new Node;
+            node->used++;
+        }
+        node = child.node;
+    }
+    Child &child = node->children[nodeIndex(vpn, numLevels - 1)];
+    if (!child.leaf) {
+        child.leaf = new Leaf;
+        node->used++;
+    }
+    return child.leaf;
+}
+
+void
+EmulationPageTable::freeLeaf(Addr vpn)
+{
+    std::vector<Node *> path;
+    path.reserve(numLevels);
+    Node *node = &root;
+    path.push_back(node);
+    for (unsigned level = 0; level + 1 < numLevels; level++) {
+        node = node->children[nodeIndex(vpn, level)].node;
+        assert(node);
+        path.push_back(node);
+    }
+
+    Child &leaf = node->children[nodeIndex(vpn, numLevels - 1)];
+    assert(leaf.leaf && leaf.leaf->valid.none());
+    delete leaf.leaf;
+    leaf.leaf = nullptr;
+    node->used--;
+
+    // Walk back up, dropping the nodes that became empty. The root is
+    // never freed.
+    for (unsigned level = numLevels - 1; level > 0 && !path[level]->used;
+         level--) {
+        delete path[level];
+        Node *parent = path[level - 1];
+        parent->children[nodeIndex(vpn, level - 1)].node = nullptr;
+        parent->used--;
+    }
+}
+
+void
+EmulationPageTable::mapPages(Addr vaddr, Addr paddr, int64_t size,
+                             uint64_t flags, bool clobber)
+{
+    while (size > 0) {
+        const Addr vpn = vaddr >> pageShift;
+        Leaf *leaf = getLeaf(vpn);
+        for (unsigned i = vpn % LeafSize; i < LeafSize && size > 0; i++) {
+            if (leaf->valid[i]) {
+                // already mapped
+                panic_if(!clobber,
+                         "EmulationPageTable::allocate: addr %#x already "
+                         "mapped", vaddr);
+            } else {
+                leaf->valid.set(i);
+            }
+            leaf->entries[i] = Entry(paddr, flags);
+
+            size -= pageSize;
+            vaddr += pageSize;
+            paddr += pageSize;
+        }
+    }
+}
+
 void
 EmulationPageTable::map(Addr vaddr, Addr paddr, int64_t size, uint64_t flags)
 {
-    bool clobber = flags & Clobber;
     // starting address must be page aligned
     assert(pageOffset(vaddr) == 0);
 
     DPRINTF(MMU, "Allocating Page: %#x-%#x\n", vaddr, vaddr + size);
 
-    while (size > 0) {
-        auto it = pTable.find(vaddr);
-        if (it != pTable.end()) {
-            // already mapped
-            panic_if(!clobber,
-                     "EmulationPageTable::allocate: addr %#x already mapped",
-                     vaddr);
-            it->second = Entry(paddr, flags);
-        } else {
-            pTable.emplace(vaddr, Entry(paddr, flags));
-        }
-
-        size -= pageSize;
-        vaddr += pageSize;
-        paddr += pageSize;
-    }
+    // Entries are replaced in place, so micro-TLBs stay valid.
+    mapPages(vaddr, paddr, size, flags, flags & Clobber);
 }
 
 void
@@ -78,23 +186,34 @@ EmulationPageTable::remap(Addr vaddr, int64_t size, Addr new_vaddr)
             new_vaddr, size);
 
     while (size > 0) {
-        auto new_it M5_VAR_USED = pTable.find(new_vaddr);
-        auto old_it = pTable.find(vaddr);
-        assert(old_it != pTable.end() && new_it == pTable.end());
+        const Addr old_vpn = vaddr >> pageShift;
+        Leaf *old_leaf = findLeaf(old_vpn);
+        assert(old_leaf && old_leaf->valid[old_vpn % LeafSize]);
+        const Entry entry = old_leaf->entries[old_vpn % LeafSize];
+
+        const Addr new_vpn = new_vaddr >> pageShift;
+        Leaf *new_leaf = getLeaf(new_vpn);
+        assert(!new_leaf->valid[new_vpn % LeafSize]);
+        new_leaf->entries[new_vpn % LeafSize] = entry;
+        new_leaf->valid.set(new_vpn % LeafSize);
+
+        old_leaf->valid.reset(old_vpn % LeafSize);
+        if (old_leaf->valid.none())
+            freeLeaf(old_vpn);
 
-        pTable.emplace(new_vaddr, old_it->second);
-        pTable.erase(old_it);
         size -= pageSize;
         vaddr += pageSize;
         new_vaddr += pageSize;
     }
+    invalidateMicroTlbs();
 }
 
 void
 EmulationPageTable::getMappings(std::vector<std::pair<Addr, Addr>> *addr_maps)
 {
-    for (auto &iter : pTable)
-        addr_maps->push_back(std::make_pair(iter.first, iter.second.paddr));
+    forEachEntry([addr_maps](Addr vaddr, const Entry &entry) {
+        addr_maps->push_back(std::make_pair(vaddr, entry.paddr));
+    });
 }
 
 void
@@ -105,12 +224,19 @@ EmulationPageTable::unmap(Addr vaddr, int64_t size)
     DPRINTF(MMU, "Unmapping page: %#x-%#x\n", vaddr, vaddr + size);
 
     while (size > 0) {
-        auto it = pTable.find(vaddr);
-        assert(it != pTable.end());
-        pTable.erase(it);
-        size -= pageSize;
-        vaddr += pageSize;
+        const Addr vpn = vaddr >> pageShift;
+        Leaf *leaf = findLeaf(vpn);
+        assert(leaf);
+        for (unsigned i = vpn % LeafSize; i < LeafSize && size > 0; i++) {
+            assert(leaf->valid[i]);
+            leaf->valid.reset(i);
+            size -= pageSize;
+            vaddr += pageSize;
+        }
+        if (leaf->valid.none())
+            freeLeaf(vpn);
     }
+    invalidateMicroTlbs();
 }
 
 bool
@@ -119,9 +245,21 @@ EmulationPageTable::isUnmapped(Addr vaddr, int64_t size)
     // starting address must be page aligned
     assert(pageOffset(vaddr) == 0);
 
-    for (int64_t offset = 0; offset < size; offset += pageSize)
-        if (pTable.find(vaddr + offset) != pTable.end())
-            return false;
+    while (size > 0) {
+        const Addr vpn = vaddr >> pageShift;
+        const unsigned first = vpn % LeafSize;
+        const unsigned pages = std::min<int64_t>(LeafSize - first,
+                                                 divCeil(size, pageSize));
+        const Leaf *leaf = findLeaf(vpn);
+        if (leaf) {
+            for (unsigned i = first; i < first + pages; i++) {
+                if (leaf->valid[i])
+                    return false;
+            }
+        }
+        size -= pages * pageSize;
+        vaddr += pages * pageSize;
+    }
 
     return true;
 }
@@ -129,11 +267,11 @@ EmulationPageTable::isUnmapped(Addr vaddr, int64_t size)
 const EmulationPageTable::Entry *
 EmulationPageTable::lookup(Addr vaddr)
 {
-    Addr page_addr = pageAlign(vaddr);
-    PTableItr iter = pTable.find(page_addr);
-    if (iter == pTable.end())
+    const Addr vpn = vaddr >> pageShift;
+    const Leaf *leaf = findLeaf(vpn);
+    if (!leaf || !leaf->valid[vpn % LeafSize])
         return nullptr;
-    return &(iter->second);
+    return &leaf->entries[vpn % LeafSize];
 }
 
 bool
@@ -152,11 +290,20 @@ EmulationPageTable::translate(Addr vaddr, Addr &paddr)
 Fault
 EmulationPageTable::translate(const RequestPtr &req)
 {
-    Addr paddr;
+    return translate(req, lookup(req->getVaddr()));
+}
+
+Fault
+EmulationPageTable::translate(const RequestPtr &req, const Entry *entry)
+{
     assert(pageAlign(req->getVaddr() + req->getSize() - 1) ==
            pageAlign(req->getVaddr()));
-    if (!translate(req->getVaddr(), paddr))
+    if (!entry) {
+        DPRINTF(MMU, "Couldn't Translate: %#x\n", req->getVaddr());
         return Fault(new GenericPageTableFault(req->getVaddr()));
+    }
+    Addr paddr = pageOffset(req->getVaddr()) + entry->paddr;
+    DPRINTF(MMU, "Translating: %#x->%#x\n", req->getVaddr(), paddr);
     req->setPaddr(paddr);
     if ((paddr & (pageSize - 1)) + req->getSize() > pageSize) {
         panic("Request spans page boundaries!\n");
@@ -168,36 +315,80 @@ EmulationPageTable::translate(const RequestPtr &req)
 void
 EmulationPageTable::serialize(CheckpointOut &cp) const
 {
-    paramOut(cp, "ptable.size", pTable.size());
+    // Store runs of pages that are contiguous in both the virtual and
+    // the physical address space, and have the same flags, rather than
+    // individual pages.
+    struct Run
+    {
+        Addr vaddr;
+        Addr paddr;
+        uint64_t flags;
+        uint64_t pages;
+    };
+    std::vector<Run> runs;
+    forEachEntry([this, &runs](Addr vaddr, const Entry &entry) {
+        if (!runs.empty()) {
+            Run &run = runs.back();
+            const Addr run_bytes = run.pages * pageSize;
+            if (run.vaddr + run_bytes == vaddr &&
+                    run.paddr + run_bytes == entry.paddr &&
+                    run.flags == entry.flags) {
+                run.pages++;
+                return;
+            }
+        }
+        runs.push_back(Run{vaddr, entry.paddr, entry.flags, 1});
+    });
 
-    PTable::size_type count = 0;
-    for (auto &pte : pTable) {
-        ScopedCheckpointSection sec(cp, csprintf("Entry%d", count++));
+    paramOut(cp, "ptable.runs", runs.size());
 
-        paramOut(cp, "vaddr", pte.first);
-        paramOut(cp, "paddr", pte.second.paddr);
-        paramOut(cp, "flags", pte.second.flags);
+    for (size_t i = 0; i < runs.size(); i++) {
+        ScopedCheckpointSection sec(cp, csprintf("Run%d", i));
+
+        paramOut(cp, "vaddr", runs[i].vaddr);
+        paramOut(cp, "paddr", runs[i].paddr);
+        paramOut(cp, "flags", runs[i].flags);
+        paramOut(cp, "pages", runs[i].pages);
     }
-    assert(count == pTable.size());
 }
 
 void
 EmulationPageTable::unserialize(CheckpointIn &cp)
 {
-    int count;
-    paramIn(cp, "ptable.size", count);
+    uint64_t runs;
+    if (optParamIn(cp, "ptable.runs", runs, false)) {
+        for (uint64_t i = 0; i < runs; ++i) {
+            ScopedCheckpointSection sec(cp, csprintf("Run%d", i));
 
-    for (int i = 0; i < count; ++i) {
-        ScopedCheckpointSection sec(cp, csprintf("Entry%d", i));
+            Addr vaddr;
+            Addr paddr;
+            uint64_t flags;
+            uint64_t pages;
+            UNSERIALIZE_SCALAR(vaddr);
+            UNSERIALIZE_SCALAR(paddr);
+            UNSERIALIZE_SCALAR(flags);
+            UNSERIALIZE_SCALAR(pages);
 
-        Addr vaddr;
-        UNSERIALIZE_SCALAR(vaddr);
-        Addr paddr;
-        uint64_t flags;
-        UNSERIALIZE_SCALAR(paddr);
-        UNSERIALIZE_SCALAR(flags);
+            mapPages(vaddr, paddr, pages * pageSize, flags, true);
+        }
+    } else {
+        // Checkpoints taken before page runs were introduced store one
+        // section per page.
+        int count;
+        paramIn(cp, "ptable.size", count);
 
-        pTable.emplace(vaddr, Entry(paddr, flags));
+        for (int i = 0; i < count; ++i) {
+            ScopedCheckpointSection sec(cp, csprintf("Entry%d", i));
+
+            Addr vaddr;
+            UNSERIALIZE_SCALAR(vaddr);
+            Addr paddr;
+            uint64_t flags;
+            UNSERIALIZE_SCALAR(paddr);
+            UNSERIALIZE_SCALAR(flags);
+
+            mapPages(vaddr, paddr, pageSize, flags, true);
+        }
     }
+    invalidateMicroTlbs();
 }
-
@@ -35,8 +35,11 @@
 #ifndef __MEM_PAGE_TABLE_HH__
 #define __MEM_PAGE_TABLE_HH__
 
+#include <array>
+#include <atomic>
+#include <bitset>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 #include "base/intmath.hh"
 #include "base/types.hh"
@@ -57,30 +60,145 @@ class EmulationPageTable : public Serializable
         Entry() {}
     };
 
+    /**
+     * A small direct-mapped cache of page table entries, meant to be
+     * kept per CPU by the SE-mode translation path of a TLB so that
+     * most accesses are served without walking the page table.
+     *
+     * Every change to a page table that may drop entries gives the table
+     * a new, globally unique generation number. A micro-TLB remembers
+     * the generation it was filled from and empties itself when that no
+     * longer matches the table it is used with, so it is also safe to
+     * use it with different page tables over time.
+     */
+    class MicroTlb
+    {
+      private:
+        friend class EmulationPageTable;
+
+        static const unsigned NumSlots = 64;
+
+        uint64_t generation;
+        std::array<Addr, NumSlots> vpns;
+        std::array<const Entry *, NumSlots> entries;
+
+        void
+        flush(uint64_t new_generation)
+        {
+            generation = new_generation;
+            entries.fill(nullptr);
+        }
+
+      public:
+        MicroTlb() { flush(0); }
+    };
+
   protected:
-    typedef std::unordered_map<Addr, Entry> PTable;
-    typedef PTable::iterator PTableItr;
-    PTable pTable;
+    /**
+     * The page table is a radix tree indexed by virtual page number.
+     * Leaves hold the entries of LeafSize consecutive pages; the
+     * interior nodes above them have NodeSize children each, and there
+     * are as many levels of them as needed to cover the whole 64-bit
+     * address space.
+     */
+    static const unsigned LeafBits = 9;
+    static const unsigned LeafSize = 1 << LeafBits;
+    static const unsigned NodeBits = 9;
+    static const unsigned NodeSize = 1 << NodeBits;
+
+    struct Leaf
+    {
+        std::array<Entry, LeafSize> entries;
+        std::bitset<LeafSize> valid;
+    };
+
+    struct Node;
+
+    union Child
+    {
+        Node *node;
+        Leaf *leaf;
+    };
+
+    struct Node
+    {
+        /** Interior nodes, or leaves for the last interior level. */
+        std::array<Child, NodeSize> children;
+        unsigned used;
+
+        Node() : used(0) { children.fill(Child{nullptr}); }
+    };
 
     const Addr pageSize;
     const Addr offsetMask;
+    const unsigned pageShift;
+
+    /** Number of interior levels, including the root. */
+    const unsigned numLevels;
+    Node root;
+
+    /** Generation of the contents, see MicroTlb. */
+    uint64_t generation;
+    static std::atomic<uint64_t> nextGeneration;
 
     const uint64_t _pid;
     const std::string _name;
 
-  public:
+    unsigned
+    nodeIndex(Addr vpn, unsigned level) const
+    {
+        return (vpn >> (LeafBits + NodeBits * (numLevels - 1 - level))) &
+               (NodeSize - 1);
+    }
 
-    EmulationPageTable(
-            const std::string &__name, uint64_t _pid, Addr _pageSize) :
-            pageSize(_pageSize), offsetMask(mask(floorLog2(_pageSize))),
-            _pid(_pid), _name(__name), shared(false)
+    /** Find the leaf covering a page, or nullptr if it does not exist. */
+    Leaf *findLeaf(Addr vpn) const;
+
+    /** Find the leaf covering a page, allocating it if necessary. */
+    Leaf *getLeaf(Addr vpn);
+
+    /** Free an empty leaf, and the interior nodes it leaves empty. */
+    void freeLeaf(Addr vpn);
+
+    void freeNode(Node *node, unsigned level);
+
+    /**
+     * Call visitor(vaddr, entry) for every mapped page, in ascending
+     * order of virtual address.
+     */
+    template <class Visitor>
+    void forEachEntry(Visitor &&visitor) const
+    {
+        forEachEntry(&root, 0, 0, visitor);
+    }
+
+    template <class Visitor>
+    void forEachEntry(const Node *node, unsigned level, Addr base_vpn,
+                      Visitor &visitor) const;
+
+    /** Map pages without the side effects of the virtual map(). */
+    void mapPages(Addr vaddr, Addr paddr, int64_t size, uint64_t flags,
+                  bool clobber);
+
+    void
+    invalidateMicroTlbs()
     {
-        assert(isPowerOf2(pageSize));
+        generation = ++nextGeneration;
     }
 
+    Fault translate(const RequestPtr &req, const Entry *entry);
+
+  public:
+
+    EmulationPageTable(
+            const std::string &__name, uint64_t _pid, Addr _pageSize);
+
+    EmulationPageTable(const EmulationPageTable &) = delete;
+    EmulationPageTable &operator=(const EmulationPageTable &) = delete;
+
     uint64_t pid() const { return _pid; };
 
-    virtual ~EmulationPageTable() {};
+    virtual ~EmulationPageTable();
 
     /* generic page table mapping flags
      *              unset | set
@@ -132,6 +250,30 @@ class EmulationPageTable : public Serializable
      */
     const Entry *lookup(Addr vaddr);
 
+    /**
+     * Lookup function going through a micro-TLB first.
+     * @param vaddr The virtual address.
+     * @param utlb The micro-TLB of the caller, filled on a miss.
+     * @return The page table entry corresponding to vaddr.
+     */
+    const Entry *
+    lookup(Addr vaddr, MicroTlb &utlb)
+    {
+        if (utlb.generation != generation)
+            utlb.flush(generation);
+        const Addr vpn = vaddr >> pageShift;
+        const unsigned slot = vpn % MicroTlb::NumSlots;
+        if (utlb.entries[slot] && utlb.vpns[slot] == vpn)
+            return utlb.entries[slot];
+
+        const Entry *entry = lookup(vaddr);
+        if (entry) {
+            utlb.vpns[slot] = vpn;
+            utlb.entries[slot] = entry;
+        }
+        return entry;
+    }
+
     /**
      * Translate function
      * @param vaddr The virtual address.
@@ -140,6 +282,23 @@ class EmulationPageTable : public Serializable
      */
     bool translate(Addr vaddr, Addr &paddr);
 
+    /**
+     * Translate function going through a micro-TLB first.
+     * @param vaddr The virtual address.
+     * @param paddr Physical address from translation.
+     * @param utlb The micro-TLB of the caller.
+     * @return True if translation exists
+     */
+    bool
+    translate(Addr vaddr, Addr &paddr, MicroTlb &utlb)
+    {
+        const Entry *entry = lookup(vaddr, utlb);
+        if (!entry)
+            return false;
+        paddr = pageOffset(vaddr) + entry->paddr;
+        return true;
+    }
+
     /**
      * Simplified translate function (just check for translation)
      * @param vaddr The virtual address.
@@ -154,10 +313,44 @@ class EmulationPageTable : public Serializable
      */
     Fault translate(const RequestPtr &req);
 
+    /**
+     * Perform a translation on the memory request going through a
+     * micro-TLB first, fills in paddr field of req.
+     * @param req The memory request.
+     * @param utlb The micro-TLB of the caller.
+     */
+    Fault
+    translate(const RequestPtr &req, MicroTlb &utlb)
+    {
+        return translate(req, lookup(req->getVaddr(), utlb));
+    }
+
     void getMappings(std::vector<std::pair<Addr, Addr>> *addr_mappings);
 
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
 };
 
+template <class Visitor>
+void
+EmulationPageTable::forEachEntry(const Node *node, unsigned level,
+                                 Addr base_vpn, Visitor &visitor) const
+{
+    const unsigned shift = LeafBits + NodeBits * (numLevels - 1 - level);
+    for (unsigned i = 0; i < NodeSize; i++) {
+        const Child &child = node->children[i];
+        const Addr vpn = base_vpn | (Addr(i) << shift);
+        if (level + 1 < numLevels) {
+            if (child.node)
+                forEachEntry(child.node, level + 1, vpn, visitor);
+        } else if (child.leaf) {
+            const Leaf &leaf = *child.leaf;
+            for (unsigned j = 0; j < LeafSize; j++) {
+                if (leaf.valid[j])
+                    visitor((vpn | j) << pageShift, leaf.entries[j]);
+            }
+        }
+    }
+}
+
 #endif // __MEM_PAGE_TABLE_HH__
@@ -28,8 +28,110 @@
 
 #include "mem/ruby/common/Consumer.hh"
 
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <vector>
+
 using namespace std;
 
+namespace
+{
+
+/**
+ * Wakeups requested by other event queues for one tick of an event queue,
+ * which happens when queues are simulated in parallel. The requests are
+ * kept per requesting queue and delivered in queue order, so the order in
+ * which consumers are woken up does not depend on the order in which the
+ * host threads made their requests.
+ */
+class RemoteWakeupEvent : public Event
+{
+  public:
+    RemoteWakeupEvent(int _target)
+        : Event(Default_Pri - 1, AutoDelete), target(_target),
+          requests(numMainEventQueues)
+    {
+    }
+
+    void process() override;
+
+    const char *
+    description() const override
+    {
+        return "Ruby remote consumer wakeup";
+    }
+
+    //! Index of the event queue this event is scheduled on
+    const int target;
+
+    //! Consumers to wake up, indexed by the requesting event queue
+    vector<vector<Consumer *>> requests;
+};
+
+//! Pending remote wakeups of one event queue, by tick
+struct RemoteWakeups
+{
+    mutex lock;
+    map<Tick, RemoteWakeupEvent *> events;
+};
+
+vector<RemoteWakeups> &
+remoteWakeups()
+{
+    // Only used in parallel mode, when the number of queues is known
+    static vector<RemoteWakeups> wakeups(numMainEventQueues);
+    return wakeups;
+}
+
+int
+eventQueueIndex(EventQueue *eq)
+{
+    auto it = find(mainEventQueue.begin(), mainEventQueue.end(), eq);
+    assert(it != mainEventQueue.end());
+    return it - mainEventQueue.begin();
+}
+
+void
+RemoteWakeupEvent::process()
+{
+    RemoteWakeups &pending = remoteWakeups()[target];
+    {
+        lock_guard<mutex> guard(pending.lock);
+        pending.events.erase(when());
+    }
+
+    // Requests are only made for ticks after the current quantum, so no
+    // other thread can still add to this event
+    for (const auto &consumers : requests) {
+        for (Consumer *consumer : consumers) {
+            consumer->scheduleEventAbsolute(when());
+        }
+    }
+}
+
+/**
+ * Request a wakeup of a consumer simulated on another event queue. The
+ * consumer is scheduled by its own queue, from a RemoteWakeupEvent
+ * inserted there at the end of the current quantum.
+ */
+void
+scheduleRemoteWakeup(Consumer *consumer, EventQueue *eq, Tick evt_time)
+{
+    const int target = eventQueueIndex(eq);
+    RemoteWakeups &pending = remoteWakeups()[target];
+
+    lock_guard<mutex> guard(pending.lock);
+    RemoteWakeupEvent *&evt = pending.events[evt_time];
+    if (evt == nullptr) {
+        evt = new RemoteWakeupEvent(target);
+        eq->schedule(evt, evt_time);
+    }
+    evt->requests[eventQueueIndex(curEventQueue())].push_back(consumer);
+}
+
+} // anonymous namespace
+
 void
 Consumer::scheduleEvent(Cycles timeDelta)
 {
@@ -39,6 +141,14 @@ Consumer::scheduleEvent(Cycles timeDelta)
 void
 Consumer::scheduleEventAbsolute(Tick evt_time)
 {
+    // When event queues are simulated in parallel, another queue may be
+    // scheduling this consumer. Relay the request to our own queue, which
+    // is the only one accessing m_scheduled_wakeups.
+    if (inParallelMode && curEventQueue() != em->eventQueue()) {
+        scheduleRemoteWakeup(this, em->eventQueue(), evt_time);
+        return;
+    }
+
     if (!alreadyScheduled(evt_time)) {
         // This wakeup is not redundant
         auto *evt = new EventFunctionWrapper(
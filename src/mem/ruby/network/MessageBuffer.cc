@@ -80,9 +80,10 @@ MessageBuffer::MessageBuffer(const Params *p)
 unsigned int
 MessageBuffer::getSize(Tick curTime)
 {
+    auto guard = lock();
     if (m_time_last_time_size_checked != curTime) {
         m_time_last_time_size_checked = curTime;
-        m_size_last_time_size_checked = m_prio_heap.size();
+        m_size_last_time_size_checked = numMessages();
     }
 
     return m_size_last_time_size_checked;
@@ -97,6 +98,8 @@ MessageBuffer::areNSlotsAvailable(unsigned int n, Tick current_time)
         return true;
     }
 
+    auto guard = lock();
+
     // determine the correct size for the current cycle
     // pop operations shouldn't effect the network's visible size
     // until schd cycle, but enqueue operations effect the visible
@@ -106,7 +109,7 @@ MessageBuffer::areNSlotsAvailable(unsigned int n, Tick current_time)
 
     if (m_time_last_time_pop < current_time) {
         // no pops this cycle - heap and stall queue size is correct
-        current_size = m_prio_heap.size();
+        current_size = numMessages();
         current_stall_size = m_stall_map_size;
     } else {
         if (m_time_last_time_enqueue < current_time) {
@@ -129,7 +132,7 @@ MessageBuffer::areNSlotsAvailable(unsigned int n, Tick current_time)
         DPRINTF(RubyQueue, "n: %d, current_size: %d, heap size: %d, "
                 "m_max_size: %d\n",
                 n, current_size + current_stall_size,
-                m_prio_heap.size(), m_max_size);
+                numMessages(), m_max_size);
         m_not_avail_count++;
         return false;
     }
@@ -138,8 +141,9 @@ MessageBuffer::areNSlotsAvailable(unsigned int n, Tick current_time)
 const Message*
 MessageBuffer::peek() const
 {
+    auto guard = lock();
     DPRINTF(RubyQueue, "Peeking at head of queue.\n");
-    const Message* msg_ptr = m_prio_heap.front().get();
+    const Message* msg_ptr = peekMsgPtr().get();
     assert(msg_ptr);
 
     DPRINTF(RubyQueue, "Message: %s\n", (*msg_ptr));
@@ -161,6 +165,7 @@ random_time()
 void
 MessageBuffer::enqueue(MsgPtr message, Tick current_time, Tick delta)
 {
+    auto guard = lock();
     // record current time incase we have a pop that also adjusts my size
     if (m_time_last_time_enqueue < current_time) {
         m_msgs_this_cycle = 0;  // first msg this cycle
@@ -219,9 +224,8 @@ MessageBuffer::enqueue(MsgPtr message, Tick current_time, Tick delta)
     msg_ptr->setLastEnqueueTime(arrival_time);
     msg_ptr->setMsgCounter(m_msg_counter);
 
-    // Insert the message into the priority heap
-    m_prio_heap.push_back(message);
-    push_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
+    // Insert the message into the buffer
+    pushMessage(message);
     // Increment the number of messages statistic
     m_buf_msgs++;
 
@@ -237,11 +241,12 @@ MessageBuffer::enqueue(MsgPtr message, Tick current_time, Tick delta)
 Tick
 MessageBuffer::dequeue(Tick current_time, bool decrement_messages)
 {
+    auto guard = lock();
     DPRINTF(RubyQueue, "Popping\n");
     assert(isReady(current_time));
 
     // get MsgPtr of the message about to be dequeued
-    MsgPtr message = m_prio_heap.front();
+    MsgPtr message = peekMsgPtr();
 
     // get the delay cycles
     message->updateDelayedTicks(current_time);
@@ -252,13 +257,12 @@ MessageBuffer::dequeue(Tick current_time, bool decrement_messages)
     // record previous size and time so the current buffer size isn't
     // adjusted until schd cycle
     if (m_time_last_time_pop < current_time) {
-        m_size_at_cycle_start = m_prio_heap.size();
+        m_size_at_cycle_start = numMessages();
         m_stalled_at_cycle_start = m_stall_map_size;
         m_time_last_time_pop = current_time;
     }
 
-    pop_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
-    m_prio_heap.pop_back();
+    popMessage();
     if (decrement_messages) {
         // If the message will be removed from the queue, decrement the
         // number of message in the queue.
@@ -276,18 +280,48 @@ MessageBuffer::dequeue(Tick current_time, bool decrement_messages)
 void
 MessageBuffer::registerDequeueCallback(std::function<void()> callback)
 {
+    auto guard = lock();
     m_dequeue_callback = callback;
 }
 
 void
 MessageBuffer::unregisterDequeueCallback()
 {
+    auto guard = lock();
     m_dequeue_callback = nullptr;
 }
 
+void
+MessageBuffer::pushMessage(const MsgPtr &message)
+{
+    // Keep the FIFO sorted: append the message if it is not older than the
+    // tail, otherwise fall back to the heap
+    if (m_fifo.empty() || !(m_fifo.back() > message)) {
+        m_fifo.push_back(message);
+    } else {
+        m_prio_heap.push_back(message);
+        push_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
+    }
+}
+
+void
+MessageBuffer::popMessage()
+{
+    assert(!isEmpty());
+    if (m_prio_heap.empty() ||
+        (!m_fifo.empty() && !(m_fifo.front() > m_prio_heap.front()))) {
+        m_fifo.pop_front();
+    } else {
+        pop_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
+        m_prio_heap.pop_back();
+    }
+}
+
 void
 MessageBuffer::clear()
 {
+    auto guard = lock();
+    m_fifo.clear();
     m_prio_heap.clear();
 
     m_msg_counter = 0;
@@ -301,16 +335,16 @@ MessageBuffer::clear()
 void
 MessageBuffer::recycle(Tick current_time, Tick recycle_latency)
 {
+    auto guard = lock();
     DPRINTF(RubyQueue, "Recycling.\n");
     assert(isReady(current_time));
-    MsgPtr node = m_prio_heap.front();
-    pop_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
+    MsgPtr node = peekMsgPtr();
+    popMessage();
 
     Tick future_time = current_time + recycle_latency;
     node->setLastEnqueueTime(future_time);
 
-    m_prio_heap.back() = node;
-    push_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
+    pushMessage(node);
     m_consumer->scheduleEventAbsolute(future_time);
 }
 
@@ -321,9 +355,7 @@ MessageBuffer::reanalyzeList(list<MsgPtr> &lt, Tick schdTick)
         MsgPtr m = lt.front();
         assert(m->getLastEnqueueTime() <= schdTick);
 
-        m_prio_heap.push_back(m);
-        push_heap(m_prio_heap.begin(), m_prio_heap.end(),
-                  greater<MsgPtr>());
+        pushMessage(m);
 
         m_consumer->scheduleEventAbsolute(schdTick);
 
@@ -337,6 +369,7 @@ MessageBuffer::reanalyzeList(list<MsgPtr> &lt, Tick schdTick)
 void
 MessageBuffer::reanalyzeMessages(Addr addr, Tick current_time)
 {
+    auto guard = lock();
     DPRINTF(RubyQueue, "ReanalyzeMessages %#x\n", addr);
     assert(m_stall_msg_map.count(addr) > 0);
 
@@ -355,6 +388,7 @@ MessageBuffer::reanalyzeMessages(Addr addr, Tick current_time)
 void
 MessageBuffer::reanalyzeAllMessages(Tick current_time)
 {
+    auto guard = lock();
     DPRINTF(RubyQueue, "ReanalyzeAllMessages\n");
 
     //
@@ -375,10 +409,11 @@ MessageBuffer::reanalyzeAllMessages(Tick current_time)
 void
 MessageBuffer::stallMessage(Addr addr, Tick current_time)
 {
+    auto guard = lock();
     DPRINTF(RubyQueue, "Stalling due to %#x\n", addr);
     assert(isReady(current_time));
     assert(getOffset(addr) == 0);
-    MsgPtr message = m_prio_heap.front();
+    MsgPtr message = peekMsgPtr();
 
     // Since the message will just be moved to stall map, indicate that the
     // buffer should not decrement the m_buf_msgs statistic
@@ -397,21 +432,24 @@ MessageBuffer::stallMessage(Addr addr, Tick current_time)
 void
 MessageBuffer::print(ostream& out) const
 {
+    auto guard = lock();
     ccprintf(out, "[MessageBuffer: ");
     if (m_consumer != NULL) {
         ccprintf(out, " consumer-yes ");
     }
 
-    vector<MsgPtr> copy(m_prio_heap);
-    sort_heap(copy.begin(), copy.end(), greater<MsgPtr>());
+    vector<MsgPtr> copy(m_fifo.begin(), m_fifo.end());
+    copy.insert(copy.end(), m_prio_heap.begin(), m_prio_heap.end());
+    sort(copy.begin(), copy.end(), greater<MsgPtr>());
     ccprintf(out, "%s] %s", copy, name());
 }
 
 bool
 MessageBuffer::isReady(Tick current_time) const
 {
-    return ((m_prio_heap.size() > 0) &&
-        (m_prio_heap.front()->getLastEnqueueTime() <= current_time));
+    auto guard = lock();
+    return (!isEmpty() &&
+        (peekMsgPtr()->getLastEnqueueTime() <= current_time));
 }
 
 void
@@ -452,13 +490,21 @@ MessageBuffer::regStats()
 uint32_t
 MessageBuffer::functionalAccess(Packet *pkt, bool is_read)
 {
+    auto guard = lock();
     DPRINTF(RubyQueue, "functional %s for %#x\n",
             is_read ? "read" : "write", pkt->getAddr());
 
     uint32_t num_functional_accesses = 0;
 
-    // Check the priority heap and write any messages that may
+    // Check the buffer and write any messages that may
     // correspond to the address in the packet.
+    for (unsigned int i = 0; i < m_fifo.size(); ++i) {
+        Message *msg = m_fifo[i].get();
+        if (is_read && msg->functionalRead(pkt))
+            return 1;
+        else if (!is_read && msg->functionalWrite(pkt))
+            num_functional_accesses++;
+    }
     for (unsigned int i = 0; i < m_prio_heap.size(); ++i) {
         Message *msg = m_prio_heap[i].get();
         if (is_read && msg->functionalRead(pkt))
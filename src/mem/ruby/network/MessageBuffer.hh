@@ -48,8 +48,10 @@
 
 #include <algorithm>
 #include <cassert>
+#include <deque>
 #include <functional>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -80,10 +82,9 @@ class MessageBuffer : public SimObject
     void
     delayHead(Tick current_time, Tick delta)
     {
-        MsgPtr m = m_prio_heap.front();
-        std::pop_heap(m_prio_heap.begin(), m_prio_heap.end(),
-                      std::greater<MsgPtr>());
-        m_prio_heap.pop_back();
+        auto guard = lock();
+        MsgPtr m = peekMsgPtr();
+        popMessage();
         enqueue(m, current_time, delta);
     }
 
@@ -104,12 +105,25 @@ class MessageBuffer : public SimObject
     Consumer* getConsumer() { return m_consumer; }
 
     bool getOrdered() { return m_strict_fifo; }
+    unsigned int getMaxSize() const { return m_max_size; }
+    bool getRandomization() const { return m_randomization; }
 
     //! Function for extracting the message at the head of the
     //! message queue.  The function assumes that the queue is nonempty.
     const Message* peek() const;
 
-    const MsgPtr &peekMsgPtr() const { return m_prio_heap.front(); }
+    //! The returned reference is only stable while the buffer is locked,
+    //! see lock(), if the producer runs on another event queue.
+    const MsgPtr &
+    peekMsgPtr() const
+    {
+        // The head is the oldest of the heads of the FIFO and the heap
+        if (m_prio_heap.empty() ||
+            (!m_fifo.empty() && !(m_fifo.front() > m_prio_heap.front()))) {
+            return m_fifo.front();
+        }
+        return m_prio_heap.front();
+    }
 
     void enqueue(MsgPtr message, Tick curTime, Tick delta);
 
@@ -121,7 +135,12 @@ class MessageBuffer : public SimObject
     void unregisterDequeueCallback();
 
     void recycle(Tick current_time, Tick recycle_latency);
-    bool isEmpty() const { return m_prio_heap.size() == 0; }
+    bool
+    isEmpty() const
+    {
+        auto guard = lock();
+        return m_fifo.empty() && m_prio_heap.empty();
+    }
     bool isStallMapEmpty() { return m_stall_msg_map.size() == 0; }
     unsigned int getStallMapSize() { return m_stall_msg_map.size(); }
 
@@ -159,15 +178,55 @@ class MessageBuffer : public SimObject
         return functionalAccess(pkt, true) == 1;
     }
 
+    /**
+     * The producer and the consumer of a buffer may be simulated on
+     * different event queues (e.g., a partitioned garnet network), in
+     * which case every access is serialised while running in parallel.
+     * The methods lock the buffer themselves; a consumer must also hold
+     * the lock while using the reference returned by peekMsgPtr().
+     */
+    std::unique_lock<std::recursive_mutex>
+    lock() const
+    {
+        std::unique_lock<std::recursive_mutex> guard(m_lock, std::defer_lock);
+        if (inParallelMode) {
+            guard.lock();
+        }
+        return guard;
+    }
+
   private:
     void reanalyzeList(std::list<MsgPtr> &, Tick);
 
+    //! Number of messages held in the FIFO and the heap.
+    unsigned int numMessages() const
+    {
+        return m_fifo.size() + m_prio_heap.size();
+    }
+
+    //! Insert a message, ordered by arrival time and message counter.
+    void pushMessage(const MsgPtr &message);
+
+    //! Remove the message at the head of the buffer.
+    void popMessage();
+
     uint32_t functionalAccess(Packet *pkt, bool is_read);
 
   private:
     // Data Members (m_ prefix)
     //! Consumer to signal a wakeup(), can be NULL
     Consumer* m_consumer;
+
+    /**
+     * Messages are kept ordered by arrival time and, for equal arrival
+     * times, by enqueue order. In the common case messages arrive in that
+     * order already, so they are appended to m_fifo, which is sorted by
+     * construction. Only messages that would break the ordering of m_fifo
+     * (e.g., shorter latencies than the last enqueued message, recycled or
+     * reanalyzed messages) are pushed into m_prio_heap. The head of the
+     * buffer is the oldest of the heads of both containers.
+     */
+    std::deque<MsgPtr> m_fifo;
     std::vector<MsgPtr> m_prio_heap;
 
     std::function<void()> m_dequeue_callback;
@@ -179,14 +238,14 @@ class MessageBuffer : public SimObject
     /**
      * A map from line addresses to lists of stalled messages for that line.
      * If this buffer allows the receiver to stall messages, on a stall
-     * request, the stalled message is removed from the m_prio_heap and placed
+     * request, the stalled message is removed from the buffer and placed
      * in the m_stall_msg_map. Messages are held there until the receiver
      * requests they be reanalyzed, at which point they are moved back to
-     * m_prio_heap.
+     * the buffer.
      *
      * NOTE: The stall map holds messages in the order in which they were
      * initially received, and when a line is unblocked, the messages are
-     * moved back to the m_prio_heap in the same order. This prevents starving
+     * moved back to the buffer in the same order. This prevents starving
      * older requests with younger ones.
      */
     StallMsgMapType m_stall_msg_map;
@@ -195,7 +254,7 @@ class MessageBuffer : public SimObject
      * Current size of the stall map.
      * Track the number of messages held in stall map lists. This is used to
      * ensure that if the buffer is finite-sized, it blocks further requests
-     * when the m_prio_heap and m_stall_msg_map contain m_max_size messages.
+     * when the buffer and m_stall_msg_map contain m_max_size messages.
      */
     int m_stall_map_size;
 
@@ -234,6 +293,8 @@ class MessageBuffer : public SimObject
     Stats::Average m_stall_time;
     Stats::Scalar m_stall_count;
     Stats::Formula m_occupancy;
+
+    mutable std::recursive_mutex m_lock;
 };
 
 Tick random_time();
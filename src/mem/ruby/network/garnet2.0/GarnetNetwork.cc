@@ -33,6 +33,7 @@
 #include <cassert>
 
 #include "base/cast.hh"
+#include "base/random.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/network/MessageBuffer.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
@@ -60,6 +61,11 @@ GarnetNetwork::GarnetNetwork(const Params *p)
     m_buffers_per_data_vc = p->buffers_per_data_vc;
     m_buffers_per_ctrl_vc = p->buffers_per_ctrl_vc;
     m_routing_algorithm = p->routing_algorithm;
+    m_garnet_threads = p->garnet_threads;
+
+    // Routers of a partitioned network pick among equally good output
+    // links with their own generator, seeded from the global one
+    m_routing_seed = isPartitioned() ? random_mt.random<uint32_t>() : 0;
 
     m_enable_fault_model = p->enable_fault_model;
     if (m_enable_fault_model)
@@ -98,6 +104,19 @@ GarnetNetwork::init()
 {
     Network::init();
 
+    // Flits, credits and messages handed to another thread are read one
+    // cycle later at the earliest, so the threads of a partitioned network
+    // have to synchronise at least once per cycle. Configs that do not set
+    // a quantum get exactly that.
+    if (isPartitioned()) {
+        if (simQuantum == 0)
+            simQuantum = clockPeriod();
+        fatal_if(simQuantum > clockPeriod(), "A garnet network split over "
+                 "%d threads needs a simulation quantum of at most one "
+                 "network cycle (%d ticks), not %d.", m_garnet_threads,
+                 clockPeriod(), simQuantum);
+    }
+
     for (int i=0; i < m_nodes; i++) {
         m_nis[i]->addNode(m_toNetQueues[i], m_fromNetQueues[i]);
     }
@@ -32,6 +32,7 @@
 #define __MEM_RUBY_NETWORK_GARNET2_0_GARNETNETWORK_HH__
 
 #include <iostream>
+#include <mutex>
 #include <vector>
 
 #include "mem/ruby/network/Network.hh"
@@ -69,6 +70,10 @@ class GarnetNetwork : public Network
     int getRoutingAlgorithm() const { return m_routing_algorithm; }
 
     bool isFaultModelEnabled() const { return m_enable_fault_model; }
+
+    // Whether routers and NIs are split over several event queues
+    bool isPartitioned() const { return m_garnet_threads > 1; }
+    uint32_t getRoutingSeed() const { return m_routing_seed; }
     FaultModel* fault_model;
 
 
@@ -140,6 +145,18 @@ class GarnetNetwork : public Network
         m_total_hops += hops;
     }
 
+    // The counters above are updated by NIs simulated on different
+    // event queues when the network is partitioned
+    std::unique_lock<std::mutex>
+    lockStats()
+    {
+        std::unique_lock<std::mutex> lock(m_stats_lock, std::defer_lock);
+        if (inParallelMode) {
+            lock.lock();
+        }
+        return lock;
+    }
+
   protected:
     // Configuration
     int m_num_rows;
@@ -150,6 +167,8 @@ class GarnetNetwork : public Network
     uint32_t m_buffers_per_data_vc;
     int m_routing_algorithm;
     bool m_enable_fault_model;
+    uint32_t m_garnet_threads;
+    uint32_t m_routing_seed;
 
     // Statistical variables
     Stats::Vector m_packets_received;
@@ -192,6 +211,8 @@ class GarnetNetwork : public Network
     std::vector<NetworkLink *> m_networklinks; // All flit links in the network
     std::vector<CreditLink *> m_creditlinks; // All credit links in the network
     std::vector<NetworkInterface *> m_nis;   // All NI's in Network
+
+    std::mutex m_stats_lock;
 };
 
 inline std::ostream&
@@ -48,6 +48,8 @@ class GarnetNetwork(RubyNetwork):
     fault_model = Param.FaultModel(NULL, "network fault model");
     garnet_deadlock_threshold = Param.UInt32(50000,
                               "network-level deadlock threshold")
+    garnet_threads = Param.UInt32(1, "number of host threads the routers "
+                                  "and network interfaces are split over");
 
 class GarnetNetworkInterface(ClockedObject):
     type = 'GarnetNetworkInterface'
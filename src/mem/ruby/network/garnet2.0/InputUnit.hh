@@ -32,9 +32,11 @@
 #ifndef __MEM_RUBY_NETWORK_GARNET2_0_INPUTUNIT_HH__
 #define __MEM_RUBY_NETWORK_GARNET2_0_INPUTUNIT_HH__
 
+#include <cstdint>
 #include <iostream>
 #include <vector>
 
+#include "base/bitfield.hh"
 #include "mem/ruby/common/Consumer.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "mem/ruby/network/garnet2.0/CreditLink.hh"
@@ -107,7 +109,47 @@ class InputUnit : public Consumer
     inline flit*
     getTopFlit(int vc)
     {
-        return virtualChannels[vc].getTopFlit();
+        flit *t_flit = virtualChannels[vc].getTopFlit();
+        if (virtualChannels[vc].isEmpty()) {
+            clear_vc_buffered(vc);
+        }
+        return t_flit;
+    }
+
+    /** Number of VCs currently holding at least one flit. */
+    inline int get_num_buffered_vcs() const { return m_num_buffered_vcs; }
+
+    /**
+     * Find the first VC holding flits, searching round robin from (and
+     * including) the given VC.
+     *
+     * @param vc The VC to start searching from.
+     * @return The VC found, -1 if all VCs are empty.
+     */
+    inline int
+    next_buffered_vc(int vc) const
+    {
+        if (m_num_buffered_vcs == 0) {
+            return -1;
+        }
+
+        const int num_vcs = virtualChannels.size();
+        if (vc >= num_vcs) {
+            vc = 0;
+        }
+
+        // Search from vc to the end, then wrap around to the start
+        const int num_words = m_buffered_vcs.size();
+        int word = vc / 64;
+        uint64_t mask = m_buffered_vcs[word] & (~0ULL << (vc % 64));
+        for (int i = 0; i <= num_words; i++) {
+            if (mask) {
+                return word * 64 + findLsbSet(mask);
+            }
+            word = (word + 1) % num_words;
+            mask = m_buffered_vcs[word];
+        }
+        return -1;
     }
 
     inline bool
@@ -158,6 +200,31 @@ class InputUnit : public Consumer
     // Input Virtual channels
     std::vector<VirtualChannel> virtualChannels;
 
+    // Bitmask of the VCs that hold flits, so that the switch allocator
+    // only looks at those
+    std::vector<uint64_t> m_buffered_vcs;
+    int m_num_buffered_vcs;
+
+    inline void
+    set_vc_buffered(int vc)
+    {
+        uint64_t &word = m_buffered_vcs[vc / 64];
+        if (!bits(word, vc % 64)) {
+            word |= 1ULL << (vc % 64);
+            m_num_buffered_vcs++;
+        }
+    }
+
+    inline void
+    clear_vc_buffered(int vc)
+    {
+        uint64_t &word = m_buffered_vcs[vc / 64];
+        if (bits(word, vc % 64)) {
+            word &= ~(1ULL << (vc % 64));
+            m_num_buffered_vcs--;
+        }
+    }
+
     // Statistical variables
     std::vector<double> m_num_buffer_writes;
     std::vector<double> m_num_buffer_reads;
@@ -40,6 +40,7 @@
 #include "mem/ruby/network/garnet2.0/Credit.hh"
 #include "mem/ruby/network/garnet2.0/flitBuffer.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
+#include "mem/ruby/system/RubySystem.hh"
 
 using namespace std;
 
@@ -109,6 +110,28 @@ NetworkInterface::addNode(vector<MessageBuffer *>& in,
             it->setConsumer(this);
         }
     }
+
+    // In a partitioned network the NI and its controller run on different
+    // event queues. Within a cycle, the slots available in a finite buffer
+    // depend on whether the other side has already dequeued, and random
+    // delays would draw from the global generator on several threads.
+    if (m_net_ptr->isPartitioned()) {
+        for (auto *buffers : {&in, &out}) {
+            for (auto *b : *buffers) {
+                if (b == nullptr) {
+                    continue;
+                }
+                fatal_if(b->getMaxSize() != 0,
+                         "%s: partitioned garnet needs infinite protocol "
+                         "buffers, %s holds %d messages.\n",
+                         name(), b->name(), b->getMaxSize());
+                fatal_if(b->getRandomization() ||
+                         RubySystem::getRandomization(),
+                         "%s: partitioned garnet does not support "
+                         "randomized buffers (%s).\n", name(), b->name());
+            }
+        }
+    }
 }
 
 void
@@ -125,6 +148,7 @@ void
 NetworkInterface::incrementStats(flit *t_flit)
 {
     int vnet = t_flit->get_vnet();
+    auto lock = m_net_ptr->lockStats();
 
     // Latency
     m_net_ptr->increment_received_flits(vnet);
@@ -174,6 +198,8 @@ NetworkInterface::wakeup()
             continue;
         }
 
+        // The controller may be enqueueing from another event queue
+        auto guard = b->lock();
         if (b->isReady(curTime)) { // Is there a message waiting
             msg_ptr = b->peekMsgPtr();
             if (flitisizeMessage(msg_ptr, vnet)) {
@@ -367,6 +393,7 @@ NetworkInterface::flitisizeMessage(MsgPtr msg_ptr, int vnet)
         // so that the first router increments it to 0
         route.hops_traversed = -1;
 
+        auto lock = m_net_ptr->lockStats();
         m_net_ptr->increment_injected_packets(vnet);
         for (int i = 0; i < num_flits; i++) {
             m_net_ptr->increment_injected_flits(vnet);
@@ -62,7 +62,10 @@ NetworkLink::wakeup()
     if (link_srcQueue->isReady(curCycle())) {
         flit *t_flit = link_srcQueue->getTopFlit();
         t_flit->set_time(curCycle() + m_latency);
-        linkBuffer.insert(t_flit);
+        {
+            auto lock = lockBuffer();
+            linkBuffer.insert(t_flit);
+        }
         link_consumer->scheduleEventAbsolute(clockEdge(m_latency));
         m_link_utilized++;
         m_vc_load[t_flit->get_vc()]++;
@@ -94,5 +97,6 @@ CreditLinkParams::create()
 uint32_t
 NetworkLink::functionalWrite(Packet *pkt)
 {
+    auto lock = lockBuffer();
     return linkBuffer.functionalWrite(pkt);
 }
@@ -33,6 +33,7 @@
 #define __MEM_RUBY_NETWORK_GARNET2_0_NETWORKLINK_HH__
 
 #include <iostream>
+#include <mutex>
 #include <vector>
 
 #include "mem/ruby/common/Consumer.hh"
@@ -61,10 +62,26 @@ class NetworkLink : public ClockedObject, public Consumer
     unsigned int getLinkUtilization() const { return m_link_utilized; }
     const std::vector<unsigned int> & getVcLoad() const { return m_vc_load; }
 
-    inline bool isReady(Cycles curTime) { return linkBuffer.isReady(curTime); }
+    inline bool
+    isReady(Cycles curTime)
+    {
+        auto lock = lockBuffer();
+        return linkBuffer.isReady(curTime);
+    }
 
-    inline flit* peekLink() { return linkBuffer.peekTopFlit(); }
-    inline flit* consumeLink() { return linkBuffer.getTopFlit(); }
+    inline flit*
+    peekLink()
+    {
+        auto lock = lockBuffer();
+        return linkBuffer.peekTopFlit();
+    }
+
+    inline flit*
+    consumeLink()
+    {
+        auto lock = lockBuffer();
+        return linkBuffer.getTopFlit();
+    }
 
     uint32_t functionalWrite(Packet *);
     void resetStats();
@@ -76,6 +93,24 @@ class NetworkLink : public ClockedObject, public Consumer
 
     flitBuffer linkBuffer;
     Consumer *link_consumer;
+
+    // The link buffer is filled on the event queue of the component
+    // feeding the link and drained on the one of its consumer, which
+    // differ when garnet is simulated in parallel. Flits always arrive
+    // at least one cycle in the future, so the lock is only needed to
+    // keep the buffer itself consistent, not to order the accesses.
+    std::mutex m_buffer_lock;
+
+    std::unique_lock<std::mutex>
+    lockBuffer()
+    {
+        std::unique_lock<std::mutex> lock(m_buffer_lock, std::defer_lock);
+        if (inParallelMode) {
+            lock.lock();
+        }
+        return lock;
+    }
+
     flitBuffer *link_srcQueue;
 
     // Statistical variables
@@ -55,6 +55,7 @@ Router::init()
 {
     BasicRouter::init();
 
+    routingUnit.init();
     switchAllocator.init();
     crossbarSwitch.init();
 }
@@ -43,6 +43,17 @@ RoutingUnit::RoutingUnit(Router *router)
     m_weight_table.clear();
 }
 
+void
+RoutingUnit::init()
+{
+    GarnetNetwork *net = m_router->get_net_ptr();
+    if (net->isPartitioned()) {
+        // Mix the router id into the network seed to decorrelate routers
+        m_rng.init(net->getRoutingSeed() ^
+                   (uint32_t(m_router->get_id()) * 0x9e3779b9U));
+    }
+}
+
 void
 RoutingUnit::addRoute(const NetDest& routing_table_entry)
 {
@@ -105,8 +116,12 @@ RoutingUnit::lookupRoutingTable(int vnet, NetDest msg_destination)
 
     // Randomly select any candidate output link
     int candidate = 0;
-    if (!(m_router->get_net_ptr())->isVNetOrdered(vnet))
-        candidate = rand() % num_candidates;
+    if (!(m_router->get_net_ptr())->isVNetOrdered(vnet)) {
+        if (m_router->get_net_ptr()->isPartitioned())
+            candidate = m_rng.random<int>(0, num_candidates - 1);
+        else
+            candidate = rand() % num_candidates;
+    }
 
     output_link = output_link_candidates.at(candidate);
     return output_link;
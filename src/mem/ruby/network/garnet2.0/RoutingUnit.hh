@@ -31,6 +31,7 @@
 #ifndef __MEM_RUBY_NETWORK_GARNET2_0_ROUTINGUNIT_HH__
 #define __MEM_RUBY_NETWORK_GARNET2_0_ROUTINGUNIT_HH__
 
+#include "base/random.hh"
 #include "mem/ruby/common/Consumer.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
@@ -44,6 +45,7 @@ class RoutingUnit
 {
   public:
     RoutingUnit(Router *router);
+    void init();
     int outportCompute(RouteInfo route,
                       int inport,
                       PortDirection inport_dirn);
@@ -72,6 +74,11 @@ class RoutingUnit
   private:
     Router *m_router;
 
+    // Picks among equally good output links when the network is
+    // partitioned over several event queues, where rand() would be shared
+    // by the host threads. Serial runs keep using rand().
+    Random m_rng;
+
     // Routing Table
     std::vector<NetDest> m_routing_table;
     std::vector<int> m_weight_table;
@@ -56,6 +56,7 @@ SwitchAllocator::init()
     m_round_robin_inport.resize(m_num_outports);
     m_round_robin_invc.resize(m_num_inports);
     m_port_requests.resize(m_num_outports);
+    m_num_port_requests.resize(m_num_outports, 0);
     m_vc_winners.resize(m_num_outports);
 
     for (int i = 0; i < m_num_inports; i++) {
@@ -94,8 +95,8 @@ SwitchAllocator::wakeup()
 }
 
 /*
- * SA-I (or SA-i) loops through all input VCs at every input port,
- * and selects one in a round robin manner.
+ * SA-I (or SA-i) loops through all input VCs holding flits at every
+ * input port, and selects one in a round robin manner.
  *    - For HEAD/HEAD_TAIL flits only selects an input VC whose output port
  *     has at least one free output VC.
  *    - For BODY/TAIL flits, only selects an input VC that has credits
@@ -109,11 +110,14 @@ SwitchAllocator::arbitrate_inports()
     // Select a VC from each input in a round robin manner
     // Independent arbiter at each input port
     for (int inport = 0; inport < m_num_inports; inport++) {
-        int invc = m_round_robin_invc[inport];
+        auto input_unit = m_router->getInputUnit(inport);
 
-        for (int invc_iter = 0; invc_iter < m_num_vcs; invc_iter++) {
-            auto input_unit = m_router->getInputUnit(inport);
+        // Empty VCs cannot be in SA, so only visit the buffered ones,
+        // in the same round robin order
+        int num_buffered_vcs = input_unit->get_num_buffered_vcs();
+        int invc = input_unit->next_buffered_vc(m_round_robin_invc[inport]);
 
+        for (int invc_iter = 0; invc_iter < num_buffered_vcs; invc_iter++) {
             if (input_unit->need_stage(invc, SA_, m_router->curCycle())) {
                 // This flit is in SA stage
 
@@ -128,6 +132,7 @@ SwitchAllocator::arbitrate_inports()
                 if (make_request) {
                     m_input_arbiter_activity++;
                     m_port_requests[outport][inport] = true;
+                    m_num_port_requests[outport]++;
                     m_vc_winners[outport][inport]= invc;
 
                     // Update Round Robin pointer to the next VC
@@ -139,9 +144,7 @@ SwitchAllocator::arbitrate_inports()
                 }
             }
 
-            invc++;
-            if (invc >= m_num_vcs)
-                invc = 0;
+            invc = input_unit->next_buffered_vc(invc + 1);
         }
     }
 }
@@ -167,6 +170,9 @@ SwitchAllocator::arbitrate_outports()
     // Again do round robin arbitration on these requests
     // Independent arbiter at each output port
     for (int outport = 0; outport < m_num_outports; outport++) {
+        if (m_num_port_requests[outport] == 0)
+            continue;
+
         int inport = m_round_robin_inport[outport];
 
         for (int inport_iter = 0; inport_iter < m_num_inports;
@@ -244,6 +250,7 @@ SwitchAllocator::arbitrate_outports()
 
                 // remove this request
                 m_port_requests[outport][inport] = false;
+                m_num_port_requests[outport]--;
 
                 // Update Round Robin pointer
                 m_round_robin_inport[outport] = inport + 1;
@@ -353,11 +360,16 @@ SwitchAllocator::check_for_wakeup()
     Cycles nextCycle = m_router->curCycle() + Cycles(1);
 
     for (int i = 0; i < m_num_inports; i++) {
-        for (int j = 0; j < m_num_vcs; j++) {
-            if (m_router->getInputUnit(i)->need_stage(j, SA_, nextCycle)) {
+        auto input_unit = m_router->getInputUnit(i);
+        int num_buffered_vcs = input_unit->get_num_buffered_vcs();
+        int vc = input_unit->next_buffered_vc(0);
+
+        for (int j = 0; j < num_buffered_vcs; j++) {
+            if (input_unit->need_stage(vc, SA_, nextCycle)) {
                 m_router->schedule_wakeup(Cycles(1));
                 return;
             }
+            vc = input_unit->next_buffered_vc(vc + 1);
         }
     }
 }
@@ -377,9 +389,13 @@ void
 SwitchAllocator::clear_request_vector()
 {
     for (int i = 0; i < m_num_outports; i++) {
+        if (m_num_port_requests[i] == 0)
+            continue;
+
         for (int j = 0; j < m_num_inports; j++) {
             m_port_requests[i][j] = false;
         }
+        m_num_port_requests[i] = 0;
     }
 }
 
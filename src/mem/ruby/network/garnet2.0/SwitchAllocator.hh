@@ -80,6 +80,8 @@ class SwitchAllocator : public Consumer
     std::vector<int> m_round_robin_invc;
     std::vector<int> m_round_robin_inport;
     std::vector<std::vector<bool>> m_port_requests;
+    // Number of inports requesting each outport in this cycle
+    std::vector<int> m_num_port_requests;
     std::vector<std::vector<int>> m_vc_winners; // a list for each outport
 };
 
@@ -61,6 +61,8 @@ class VirtualChannel
         return inputBuffer.isReady(curTime);
     }
 
+    inline bool isEmpty() { return inputBuffer.isEmpty(); }
+
     inline void
     insertFlit(flit *t_flit)
     {
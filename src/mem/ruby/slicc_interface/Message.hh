@@ -114,6 +114,115 @@ class Message
     int vnet;
 };
 
+/**
+ * Allocator that recycles the storage of messages. Protocol messages are
+ * created and destroyed at a high rate and share a handful of sizes, so
+ * freed blocks are kept in a per-type free list and handed out again
+ * instead of going back to the heap. It is meant to be used with
+ * std::allocate_shared, which rebinds it to the type holding both the
+ * message and its reference counts.
+ *
+ * @tparam T The type of the allocated objects.
+ */
+template <class T>
+class MessageAllocator
+{
+  private:
+    /** A free block, linked to the next free block of the same type. */
+    union FreeBlock
+    {
+        FreeBlock *next;
+        alignas(T) char storage[sizeof(T)];
+    };
+
+    /**
+     * List of free blocks. Garnet routers may be simulated on several
+     * host threads, so each thread keeps its own list; a block freed on
+     * a thread other than the one that allocated it simply moves to the
+     * list of the freeing thread. The list is bounded, and its blocks are
+     * returned to the heap when the thread exits.
+     */
+    struct FreeList
+    {
+        FreeBlock *head = nullptr;
+        std::size_t size = 0;
+
+        ~FreeList()
+        {
+            while (head) {
+                FreeBlock *block = head;
+                head = block->next;
+                delete block;
+            }
+        }
+    };
+
+    /** Maximum number of free blocks kept per type and thread. */
+    static constexpr std::size_t maxFreeBlocks = 4096;
+
+    static thread_local FreeList freeList;
+
+  public:
+    typedef T value_type;
+
+    MessageAllocator() = default;
+
+    template <class U>
+    MessageAllocator(const MessageAllocator<U> &other) {}
+
+    T*
+    allocate(std::size_t n)
+    {
+        if (n != 1) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        FreeList &list = freeList;
+        if (list.head) {
+            FreeBlock *block = list.head;
+            list.head = block->next;
+            list.size--;
+            return reinterpret_cast<T*>(block);
+        }
+        return reinterpret_cast<T*>(new FreeBlock);
+    }
+
+    void
+    deallocate(T *p, std::size_t n)
+    {
+        if (n != 1) {
+            ::operator delete(p);
+            return;
+        }
+        FreeBlock *block = reinterpret_cast<FreeBlock*>(p);
+        FreeList &list = freeList;
+        if (list.size == maxFreeBlocks) {
+            delete block;
+            return;
+        }
+        block->next = list.head;
+        list.head = block;
+        list.size++;
+    }
+};
+
+template <class T>
+thread_local typename MessageAllocator<T>::FreeList
+    MessageAllocator<T>::freeList;
+
+template <class T, class U>
+inline bool
+operator==(const MessageAllocator<T> &, const MessageAllocator<U> &)
+{
+    return true;
+}
+
+template <class T, class U>
+inline bool
+operator!=(const MessageAllocator<T> &, const MessageAllocator<U> &)
+{
+    return false;
+}
+
 inline bool
 operator>(const MsgPtr &lhs, const MsgPtr &rhs)
 {
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_STRUCTURES_FLATADDRMAP_HH__
+#define __MEM_RUBY_STRUCTURES_FLATADDRMAP_HH__
+
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <new>
+#include <vector>
+
+#include "mem/ruby/common/Address.hh"
+
+/**
+ * A bounded map from line addresses to values, meant for the small
+ * per-controller tables Ruby probes on every message (TBEs, outstanding
+ * sequencer requests).
+ *
+ * Values live in a slot pool sized from the expected number of live
+ * entries; the pool only ever grows by appending, so a pointer to a
+ * value stays valid until that value is erased, as it did with the
+ * node-based std::unordered_map this replaces. Lookups go through a
+ * linear-probing index of (address, slot) pairs that is kept at most half
+ * full; erasure uses backward shifting, so no tombstones accumulate.
+ *
+ * Exceeding the initial capacity is allowed and simply grows the pool
+ * and the index.
+ */
+template<class VALUE>
+class FlatAddrMap
+{
+  private:
+    static const int32_t invalidSlot = -1;
+
+    struct Bucket
+    {
+        Addr addr;
+        int32_t slot;
+    };
+
+    /** Value storage; indices are stable for the lifetime of the map. */
+    std::deque<VALUE> m_values;
+    /** Unused slots of m_values. */
+    std::vector<int32_t> m_freeSlots;
+    /** Open-addressing index, its size is always a power of two. */
+    std::vector<Bucket> m_buckets;
+    std::size_t m_mask;
+    std::size_t m_size;
+
+    std::size_t
+    home(Addr addr) const
+    {
+        // Fibonacci hashing, so that line-aligned addresses still spread
+        // over the whole index
+        return (addr * 0x9E3779B97F4A7C15ULL) >> 32 & m_mask;
+    }
+
+    std::size_t
+    findBucket(Addr addr) const
+    {
+        std::size_t idx = home(addr);
+        while (m_buckets[idx].slot != invalidSlot &&
+               m_buckets[idx].addr != addr) {
+            idx = (idx + 1) & m_mask;
+        }
+        return idx;
+    }
+
+    void
+    resizeIndex(std::size_t num_buckets)
+    {
+        std::vector<Bucket> old_buckets(num_buckets,
+                                        Bucket{0, invalidSlot});
+        old_buckets.swap(m_buckets);
+        m_mask = num_buckets - 1;
+        for (const auto &bucket : old_buckets) {
+            if (bucket.slot != invalidSlot) {
+                m_buckets[findBucket(bucket.addr)] = bucket;
+            }
+        }
+    }
+
+  public:
+    explicit FlatAddrMap(std::size_t capacity)
+        : m_values(capacity), m_mask(0), m_size(0)
+    {
+        m_freeSlots.reserve(capacity);
+        for (std::size_t i = capacity; i > 0; i--) {
+            m_freeSlots.push_back(i - 1);
+        }
+
+        std::size_t num_buckets = 8;
+        while (num_buckets < 2 * capacity) {
+            num_buckets <<= 1;
+        }
+        resizeIndex(num_buckets);
+    }
+
+    FlatAddrMap(const FlatAddrMap &) = delete;
+    FlatAddrMap &operator=(const FlatAddrMap &) = delete;
+
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    VALUE *
+    find(Addr addr)
+    {
+        const Bucket &bucket = m_buckets[findBucket(addr)];
+        return bucket.slot == invalidSlot ? nullptr :
+                                            &m_values[bucket.slot];
+    }
+
+    const VALUE *
+    find(Addr addr) const
+    {
+        const Bucket &bucket = m_buckets[findBucket(addr)];
+        return bucket.slot == invalidSlot ? nullptr :
+                                            &m_values[bucket.slot];
+    }
+
+    /**
+     * Insert a default-constructed value for an address that is not in
+     * the map yet.
+     *
+     * @param addr The address to insert.
+     * @return The new value.
+     */
+    VALUE &
+    insert(Addr addr)
+    {
+        if (2 * (m_size + 1) > m_buckets.size()) {
+            resizeIndex(2 * m_buckets.size());
+        }
+
+        std::size_t idx = findBucket(addr);
+        assert(m_buckets[idx].slot == invalidSlot);
+
+        int32_t slot;
+        if (m_freeSlots.empty()) {
+            slot = m_values.size();
+            m_values.emplace_back();
+        } else {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+            // Reset whatever the previous owner of the slot left behind
+            m_values[slot].~VALUE();
+            new (&m_values[slot]) VALUE();
+        }
+
+        m_buckets[idx] = Bucket{addr, slot};
+        m_size++;
+        return m_values[slot];
+    }
+
+    /**
+     * Remove an address from the map. The value itself is only reset
+     * when its slot gets reused, so references to it may still be used
+     * until the next insertion.
+     *
+     * @param addr The address to remove.
+     */
+    void
+    erase(Addr addr)
+    {
+        std::size_t idx = findBucket(addr);
+        assert(m_buckets[idx].slot != invalidSlot);
+        m_freeSlots.push_back(m_buckets[idx].slot);
+        m_size--;
+
+        // Backward-shift the rest of the probe run into the hole
+        std::size_t next = (idx + 1) & m_mask;
+        while (m_buckets[next].slot != invalidSlot) {
+            std::size_t next_home = home(m_buckets[next].addr);
+            if (((next - next_home) & m_mask) >= ((next - idx) & m_mask)) {
+                m_buckets[idx] = m_buckets[next];
+                idx = next;
+            }
+            next = (next + 1) & m_mask;
+        }
+        m_buckets[idx].slot = invalidSlot;
+    }
+
+    /**
+     * Visit every entry in the map, in no particular order.
+     *
+     * @param visitor Callable taking the address and a reference to the
+     *                value.
+     */
+    template<class VISITOR>
+    void
+    forEach(VISITOR &&visitor)
+    {
+        for (const auto &bucket : m_buckets) {
+            if (bucket.slot != invalidSlot) {
+                visitor(bucket.addr, m_values[bucket.slot]);
+            }
+        }
+    }
+
+    template<class VISITOR>
+    void
+    forEach(VISITOR &&visitor) const
+    {
+        for (const auto &bucket : m_buckets) {
+            if (bucket.slot != invalidSlot) {
+                visitor(bucket.addr, m_values[bucket.slot]);
+            }
+        }
+    }
+};
+
+#endif // __MEM_RUBY_STRUCTURES_FLATADDRMAP_HH__
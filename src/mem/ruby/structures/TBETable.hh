@@ -42,16 +42,16 @@
 #define __MEM_RUBY_STRUCTURES_TBETABLE_HH__
 
 #include <iostream>
-#include <unordered_map>
 
 #include "mem/ruby/common/Address.hh"
+#include "mem/ruby/structures/FlatAddrMap.hh"
 
 template<class ENTRY>
 class TBETable
 {
   public:
     TBETable(int number_of_TBEs)
-        : m_number_of_TBEs(number_of_TBEs)
+        : m_map(number_of_TBEs), m_number_of_TBEs(number_of_TBEs)
     {
     }
 
@@ -76,7 +76,7 @@ class TBETable
     TBETable& operator=(const TBETable& obj);
 
     // Data Members (m_prefix)
-    std::unordered_map<Addr, ENTRY> m_map;
+    FlatAddrMap<ENTRY> m_map;
 
   private:
     int m_number_of_TBEs;
@@ -97,7 +97,7 @@ TBETable<ENTRY>::isPresent(Addr address) const
 {
     assert(address == makeLineAddress(address));
     assert(m_map.size() <= m_number_of_TBEs);
-    return !!m_map.count(address);
+    return m_map.find(address) != nullptr;
 }
 
 template<class ENTRY>
@@ -106,7 +106,7 @@ TBETable<ENTRY>::allocate(Addr address)
 {
     assert(!isPresent(address));
     assert(m_map.size() < m_number_of_TBEs);
-    m_map[address] = ENTRY();
+    m_map.insert(address);
 }
 
 template<class ENTRY>
@@ -130,8 +130,7 @@ template<class ENTRY>
 inline ENTRY*
 TBETable<ENTRY>::lookup(Addr address)
 {
-  if (m_map.find(address) != m_map.end()) return &(m_map.find(address)->second);
-  return NULL;
+    return m_map.find(address);
 }
 
 
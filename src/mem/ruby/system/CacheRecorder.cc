@@ -29,6 +29,12 @@
 
 #include "mem/ruby/system/CacheRecorder.hh"
 
+#include <fcntl.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+
 #include "debug/RubyCacheTrace.hh"
 #include "mem/ruby/system/RubySystem.hh"
 #include "mem/ruby/system/Sequencer.hh"
@@ -43,47 +49,69 @@ TraceRecord::print(ostream& out) const
         << m_type << ", Time: " << m_time << "]";
 }
 
-CacheRecorder::CacheRecorder()
-    : m_uncompressed_trace(NULL),
-      m_uncompressed_trace_size(0),
-      m_block_size_bytes(RubySystem::getBlockSizeBytes())
+CacheRecorder::CacheRecorder(std::vector<Sequencer*>& seq_map,
+                             uint64_t block_size_bytes)
+    : m_uncompressed_trace_size(0),
+      m_seq_map(seq_map), m_bytes_read(0), m_records_read(0),
+      m_records_flushed(0), m_block_size_bytes(block_size_bytes),
+      m_num_records(0), m_trace_file(NULL)
 {
 }
 
-CacheRecorder::CacheRecorder(uint8_t* uncompressed_trace,
+CacheRecorder::CacheRecorder(const std::string &trace_file,
                              uint64_t uncompressed_trace_size,
                              std::vector<Sequencer*>& seq_map,
                              uint64_t block_size_bytes)
-    : m_uncompressed_trace(uncompressed_trace),
-      m_uncompressed_trace_size(uncompressed_trace_size),
+    : m_uncompressed_trace_size(uncompressed_trace_size),
       m_seq_map(seq_map),  m_bytes_read(0), m_records_read(0),
-      m_records_flushed(0), m_block_size_bytes(block_size_bytes)
+      m_records_flushed(0), m_block_size_bytes(block_size_bytes),
+      m_num_records(0), m_trace_file(NULL), m_trace_filename(trace_file),
+      m_replay_record(new uint8_t[recordSize()])
 {
-    if (m_uncompressed_trace != NULL) {
-        if (m_block_size_bytes < RubySystem::getBlockSizeBytes()) {
-            // Block sizes larger than when the trace was recorded are not
-            // supported, as we cannot reliably turn accesses to smaller blocks
-            // into larger ones.
-            panic("Recorded cache block size (%d) < current block size (%d) !!",
-                    m_block_size_bytes, RubySystem::getBlockSizeBytes());
-        }
+    if (m_block_size_bytes < RubySystem::getBlockSizeBytes()) {
+        // Block sizes larger than when the trace was recorded are not
+        // supported, as we cannot reliably turn accesses to smaller blocks
+        // into larger ones.
+        panic("Recorded cache block size (%d) < current block size (%d) !!",
+                m_block_size_bytes, RubySystem::getBlockSizeBytes());
+    }
+
+    int fd = open(trace_file.c_str(), O_RDONLY);
+    if (fd < 0) {
+        perror("open");
+        fatal("Unable to open trace file %s", trace_file);
     }
+
+    m_trace_file = gzdopen(fd, "rb");
+    if (m_trace_file == NULL) {
+        fatal("Insufficient memory to allocate compression state for %s\n",
+              trace_file);
+    }
+    gzbuffer(m_trace_file, traceBufferSize);
 }
 
 CacheRecorder::~CacheRecorder()
 {
-    if (m_uncompressed_trace != NULL) {
-        delete [] m_uncompressed_trace;
-        m_uncompressed_trace = NULL;
+    if (m_trace_file != NULL) {
+        gzclose(m_trace_file);
+        m_trace_file = NULL;
     }
     m_seq_map.clear();
 }
 
+TraceRecord *
+CacheRecorder::getRecord(uint64_t idx) const
+{
+    assert(idx < m_num_records);
+    return (TraceRecord *)(m_record_chunks[idx / recordsPerChunk].get() +
+                           (idx % recordsPerChunk) * recordSize());
+}
+
 void
 CacheRecorder::enqueueNextFlushRequest()
 {
-    if (m_records_flushed < m_records.size()) {
-        TraceRecord* rec = m_records[m_records_flushed];
+    if (m_records_flushed < m_num_records) {
+        TraceRecord* rec = getRecord(m_records_flushed);
         m_records_flushed++;
         auto req = std::make_shared<Request>(rec->m_data_address,
                                              m_block_size_bytes, 0,
@@ -105,8 +133,15 @@ void
 CacheRecorder::enqueueNextFetchRequest()
 {
     if (m_bytes_read < m_uncompressed_trace_size) {
-        TraceRecord* traceRecord = (TraceRecord*) (m_uncompressed_trace +
-                                                                m_bytes_read);
+        // Only the record being issued is decompressed, the packets get a
+        // copy of its data so that it can be overwritten by the next one
+        assert(m_trace_file != NULL);
+        if (gzread(m_trace_file, m_replay_record.get(), recordSize()) <
+                (int)recordSize()) {
+            fatal("Unable to read complete trace from file %s\n",
+                  m_trace_filename);
+        }
+        TraceRecord* traceRecord = (TraceRecord*)m_replay_record.get();
 
         DPRINTF(RubyCacheTrace, "Issuing %s\n", *traceRecord);
 
@@ -134,16 +169,24 @@ CacheRecorder::enqueueNextFetchRequest()
             }
 
             Packet *pkt = new Packet(req, requestType);
-            pkt->dataStatic(traceRecord->m_data + rec_bytes_read);
+            pkt->allocate();
+            pkt->setData(traceRecord->m_data + rec_bytes_read);
 
             Sequencer* m_sequencer_ptr = m_seq_map[traceRecord->m_cntrl_id];
             assert(m_sequencer_ptr != NULL);
             m_sequencer_ptr->makeRequest(pkt);
         }
 
-        m_bytes_read += (sizeof(TraceRecord) + m_block_size_bytes);
+        m_bytes_read += recordSize();
         m_records_read++;
     } else {
+        if (m_trace_file != NULL) {
+            if (gzclose(m_trace_file)) {
+                fatal("Failed to close cache trace file '%s'\n",
+                      m_trace_filename);
+            }
+            m_trace_file = NULL;
+        }
         DPRINTF(RubyCacheTrace, "Fetched all %d records\n", m_records_read);
     }
 }
@@ -152,8 +195,11 @@ void
 CacheRecorder::addRecord(int cntrl, Addr data_addr, Addr pc_addr,
                          RubyRequestType type, Tick time, DataBlock& data)
 {
-    TraceRecord* rec = (TraceRecord*)malloc(sizeof(TraceRecord) +
-                                            m_block_size_bytes);
+    if (m_num_records % recordsPerChunk == 0) {
+        m_record_chunks.emplace_back(
+            new uint8_t[recordsPerChunk * recordSize()]);
+    }
+    TraceRecord* rec = getRecord(m_num_records++);
     rec->m_cntrl_id     = cntrl;
     rec->m_time         = time;
     rec->m_data_address = data_addr;
@@ -161,42 +207,44 @@ CacheRecorder::addRecord(int cntrl, Addr data_addr, Addr pc_addr,
     rec->m_type         = type;
     memcpy(rec->m_data, data.getData(0, m_block_size_bytes),
            m_block_size_bytes);
-
-    m_records.push_back(rec);
 }
 
 uint64_t
-CacheRecorder::aggregateRecords(uint8_t **buf, uint64_t total_size)
+CacheRecorder::writeTrace(const std::string &filename)
 {
-    std::sort(m_records.begin(), m_records.end(), compareTraceRecords);
-
-    int size = m_records.size();
-    uint64_t current_size = 0;
-    int record_size = sizeof(TraceRecord) + m_block_size_bytes;
-
-    for (int i = 0; i < size; ++i) {
-        // Determine if we need to expand the buffer size
-        if (current_size + record_size > total_size) {
-            uint8_t* new_buf = new (nothrow) uint8_t[total_size * 2];
-            if (new_buf == NULL) {
-                fatal("Unable to allocate buffer of size %s\n",
-                      total_size * 2);
-            }
-            total_size = total_size * 2;
-            uint8_t* old_buf = *buf;
-            memcpy(new_buf, old_buf, current_size);
-            *buf = new_buf;
-            delete [] old_buf;
-        }
+    // Sort an index of the records rather than the records themselves
+    std::vector<uint64_t> order(m_num_records);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [this](uint64_t a, uint64_t b)
+                     { return compareTraceRecords(getRecord(a),
+                                                  getRecord(b)); });
+
+    int fd = creat(filename.c_str(), 0664);
+    if (fd < 0) {
+        perror("creat");
+        fatal("Can't open memory trace file '%s'\n", filename);
+    }
+
+    gzFile compressedMemory = gzdopen(fd, "wb");
+    if (compressedMemory == NULL)
+        fatal("Insufficient memory to allocate compression state for %s\n",
+              filename);
+    gzbuffer(compressedMemory, traceBufferSize);
 
-        // Copy the current record into the buffer
-        memcpy(&((*buf)[current_size]), m_records[i], record_size);
-        current_size += record_size;
+    for (uint64_t idx : order) {
+        if (gzwrite(compressedMemory, getRecord(idx), recordSize()) !=
+            (int)recordSize()) {
+            fatal("Write failed on memory trace file '%s'\n", filename);
+        }
+    }
 
-        free(m_records[i]);
-        m_records[i] = NULL;
+    if (gzclose(compressedMemory)) {
+        fatal("Close failed on memory trace file '%s'\n", filename);
     }
 
-    m_records.clear();
-    return current_size;
+    uint64_t trace_size = m_num_records * recordSize();
+    m_record_chunks.clear();
+    m_num_records = 0;
+    return trace_size;
 }
@@ -29,12 +29,17 @@
 
 /*
  * Recording cache requests made to a ruby cache at certain ruby
- * time. Also dump the requests to a gziped file.
+ * time. Also dump the requests to a gziped file, and stream them back
+ * from it when warming up the caches.
  */
 
 #ifndef __MEM_RUBY_SYSTEM_CACHERECORDER_HH__
 #define __MEM_RUBY_SYSTEM_CACHERECORDER_HH__
 
+#include <zlib.h>
+
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "base/types.hh"
@@ -66,17 +71,35 @@ class TraceRecord {
 class CacheRecorder
 {
   public:
-    CacheRecorder();
-    ~CacheRecorder();
+    /*!
+     * Create a recorder to be filled with addRecord(), used to flush the
+     * caches and to write the trace to a checkpoint.
+     */
+    CacheRecorder(std::vector<Sequencer*>& SequencerMap,
+                  uint64_t block_size_bytes);
 
-    CacheRecorder(uint8_t* uncompressed_trace,
+    /*!
+     * Create a recorder replaying a trace written by writeTrace(). The
+     * trace is decompressed incrementally as the records are fetched.
+     */
+    CacheRecorder(const std::string &trace_file,
                   uint64_t uncompressed_trace_size,
                   std::vector<Sequencer*>& SequencerMap,
                   uint64_t block_size_bytes);
+    ~CacheRecorder();
+
     void addRecord(int cntrl, Addr data_addr, Addr pc_addr,
                    RubyRequestType type, Tick time, DataBlock& data);
 
-    uint64_t aggregateRecords(uint8_t **data, uint64_t size);
+    /*!
+     * Write the recorded records, most recently accessed first, to a
+     * gziped file. Records are compressed as they are written, so no
+     * aggregated copy of the trace is built.
+     *
+     * @param filename Path of the file to create.
+     * @return The uncompressed size of the trace.
+     */
+    uint64_t writeTrace(const std::string &filename);
 
     /*!
      * Function for flushing the memory contents of the caches to the
@@ -102,14 +125,34 @@ class CacheRecorder
     CacheRecorder(const CacheRecorder& obj);
     CacheRecorder& operator=(const CacheRecorder& obj);
 
-    std::vector<TraceRecord*> m_records;
-    uint8_t* m_uncompressed_trace;
     uint64_t m_uncompressed_trace_size;
     std::vector<Sequencer*> m_seq_map;
     uint64_t m_bytes_read;
     uint64_t m_records_read;
     uint64_t m_records_flushed;
     uint64_t m_block_size_bytes;
+
+    uint64_t recordSize() const
+    { return sizeof(TraceRecord) + m_block_size_bytes; }
+
+    TraceRecord *getRecord(uint64_t idx) const;
+
+    /*!
+     * Records are stored back to back in fixed-size chunks, so that
+     * recording a large cache neither allocates every record separately
+     * nor copies the ones already recorded when growing.
+     */
+    static const uint64_t recordsPerChunk = 1024;
+    /*! zlib buffer size used when streaming the trace to and from disk. */
+    static const unsigned traceBufferSize = 1 << 17;
+    std::vector<std::unique_ptr<uint8_t[]>> m_record_chunks;
+    uint64_t m_num_records;
+
+    /*! Trace being replayed, nullptr once it has been read entirely. */
+    gzFile m_trace_file;
+    std::string m_trace_filename;
+    /*! Last record read from the trace being replayed. */
+    std::unique_ptr<uint8_t[]> m_replay_record;
 };
 
 inline bool
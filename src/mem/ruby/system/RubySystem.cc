@@ -40,10 +40,6 @@
 
 #include "mem/ruby/system/RubySystem.hh"
 
-#include <fcntl.h>
-#include <zlib.h>
-
-#include <cstdio>
 #include <list>
 
 #include "base/intmath.hh"
@@ -113,7 +109,7 @@ RubySystem::~RubySystem()
 }
 
 void
-RubySystem::makeCacheRecorder(uint8_t *uncompressed_trace,
+RubySystem::makeCacheRecorder(const string &trace_file,
                               uint64_t cache_trace_size,
                               uint64_t block_size_bytes)
 {
@@ -141,8 +137,12 @@ RubySystem::makeCacheRecorder(uint8_t *uncompressed_trace,
     }
 
     // Create the CacheRecorder and record the cache trace
-    m_cache_recorder = new CacheRecorder(uncompressed_trace, cache_trace_size,
-                                         sequencer_map, block_size_bytes);
+    if (trace_file.empty()) {
+        m_cache_recorder = new CacheRecorder(sequencer_map, block_size_bytes);
+    } else {
+        m_cache_recorder = new CacheRecorder(trace_file, cache_trace_size,
+                                             sequencer_map, block_size_bytes);
+    }
 }
 
 void
@@ -152,7 +152,7 @@ RubySystem::memWriteback()
 
     // Make the trace so we know what to write back.
     DPRINTF(RubyCacheTrace, "Recording Cache Trace\n");
-    makeCacheRecorder(NULL, 0, getBlockSizeBytes());
+    makeCacheRecorder("", 0, getBlockSizeBytes());
     for (int cntrl = 0; cntrl < m_abs_cntrl_vec.size(); cntrl++) {
         m_abs_cntrl_vec[cntrl]->recordCacheTrace(cntrl, m_cache_recorder);
     }
@@ -217,35 +217,6 @@ RubySystem::memWriteback()
     // checkpoint is immediately taken.
 }
 
-void
-RubySystem::writeCompressedTrace(uint8_t *raw_data, string filename,
-                                 uint64_t uncompressed_trace_size)
-{
-    // Create the checkpoint file for the memory
-    string thefile = CheckpointIn::dir() + "/" + filename.c_str();
-
-    int fd = creat(thefile.c_str(), 0664);
-    if (fd < 0) {
-        perror("creat");
-        fatal("Can't open memory trace file '%s'\n", filename);
-    }
-
-    gzFile compressedMemory = gzdopen(fd, "wb");
-    if (compressedMemory == NULL)
-        fatal("Insufficient memory to allocate compression state for %s\n",
-              filename);
-
-    if (gzwrite(compressedMemory, raw_data, uncompressed_trace_size) !=
-        uncompressed_trace_size) {
-        fatal("Write failed on memory trace file '%s'\n", filename);
-    }
-
-    if (gzclose(compressedMemory)) {
-        fatal("Close failed on memory trace file '%s'\n", filename);
-    }
-    delete[] raw_data;
-}
-
 void
 RubySystem::serialize(CheckpointOut &cp) const
 {
@@ -262,12 +233,10 @@ RubySystem::serialize(CheckpointOut &cp) const
         fatal("Call memWriteback() before serialize() to create ruby trace");
     }
 
-    // Aggregate the trace entries together into a single array
-    uint8_t *raw_data = new uint8_t[4096];
-    uint64_t cache_trace_size = m_cache_recorder->aggregateRecords(&raw_data,
-                                                                 4096);
+    // Stream the trace entries to the checkpoint directory
     string cache_trace_file = name() + ".cache.gz";
-    writeCompressedTrace(raw_data, cache_trace_file, cache_trace_size);
+    uint64_t cache_trace_size = m_cache_recorder->writeTrace(
+        CheckpointIn::dir() + "/" + cache_trace_file);
 
     SERIALIZE_SCALAR(cache_trace_file);
     SERIALIZE_SCALAR(cache_trace_size);
@@ -284,42 +253,9 @@ RubySystem::drainResume()
     }
 }
 
-void
-RubySystem::readCompressedTrace(string filename, uint8_t *&raw_data,
-                                uint64_t &uncompressed_trace_size)
-{
-    // Read the trace file
-    gzFile compressedTrace;
-
-    // trace file
-    int fd = open(filename.c_str(), O_RDONLY);
-    if (fd < 0) {
-        perror("open");
-        fatal("Unable to open trace file %s", filename);
-    }
-
-    compressedTrace = gzdopen(fd, "rb");
-    if (compressedTrace == NULL) {
-        fatal("Insufficient memory to allocate compression state for %s\n",
-              filename);
-    }
-
-    raw_data = new uint8_t[uncompressed_trace_size];
-    if (gzread(compressedTrace, raw_data, uncompressed_trace_size) <
-            uncompressed_trace_size) {
-        fatal("Unable to read complete trace from file %s\n", filename);
-    }
-
-    if (gzclose(compressedTrace)) {
-        fatal("Failed to close cache trace file '%s'\n", filename);
-    }
-}
-
 void
 RubySystem::unserialize(CheckpointIn &cp)
 {
-    uint8_t *uncompressed_trace = NULL;
-
     // This value should be set to the checkpoint-system's block-size.
     // Optional, as checkpoints without it can be run if the
     // checkpoint-system's block-size == current block-size.
@@ -333,13 +269,12 @@ RubySystem::unserialize(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(cache_trace_size);
     cache_trace_file = cp.getCptDir() + "/" + cache_trace_file;
 
-    readCompressedTrace(cache_trace_file, uncompressed_trace,
-                        cache_trace_size);
     m_warmup_enabled = true;
     m_systems_to_warmup++;
 
-    // Create the cache recorder that will hang around until startup.
-    makeCacheRecorder(uncompressed_trace, cache_trace_size, block_size_bytes);
+    // Create the cache recorder that will hang around until startup. The
+    // trace is only read as the warmup requests are issued.
+    makeCacheRecorder(cache_trace_file, cache_trace_size, block_size_bytes);
 }
 
 void
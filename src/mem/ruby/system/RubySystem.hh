@@ -106,16 +106,14 @@ class RubySystem : public ClockedObject
     RubySystem(const RubySystem& obj);
     RubySystem& operator=(const RubySystem& obj);
 
-    void makeCacheRecorder(uint8_t *uncompressed_trace,
+    /**
+     * Create the cache recorder, either empty to record the cache contents
+     * (empty trace_file) or replaying the given checkpointed trace.
+     */
+    void makeCacheRecorder(const std::string &trace_file,
                            uint64_t cache_trace_size,
                            uint64_t block_size_bytes);
 
-    static void readCompressedTrace(std::string filename,
-                                    uint8_t *&raw_data,
-                                    uint64_t &uncompressed_trace_size);
-    static void writeCompressedTrace(uint8_t *raw_data, std::string file,
-                                     uint64_t uncompressed_trace_size);
-
     void processRubyEvent();
   private:
     // configuration parameters
@@ -67,7 +67,8 @@ RubySequencerParams::create()
 }
 
 Sequencer::Sequencer(const Params *p)
-    : RubyPort(p), m_IncompleteTimes(MachineType_NUM),
+    : RubyPort(p), m_RequestTable(p->max_outstanding_requests),
+      m_IncompleteTimes(MachineType_NUM),
       deadlockCheckEvent([this]{ wakeup(); }, "Sequencer deadlock check")
 {
     m_outstanding_count = 0;
@@ -159,21 +160,22 @@ Sequencer::wakeup()
     // Check across all outstanding requests
     int total_outstanding = 0;
 
-    for (const auto &table_entry : m_RequestTable) {
-        for (const auto seq_req : table_entry.second) {
+    m_RequestTable.forEach([&](Addr addr,
+                               const SequencerRequestList &seq_req_list) {
+        seq_req_list.forEach([&](const SequencerRequest &seq_req) {
             if (current_time - seq_req.issue_time < m_deadlock_threshold)
-                continue;
+                return;
 
             panic("Possible Deadlock detected. Aborting!\n version: %d "
                   "request.paddr: 0x%x m_readRequestTable: %d current time: "
                   "%u issue_time: %d difference: %d\n", m_version,
-                  seq_req.pkt->getAddr(), table_entry.second.size(),
+                  seq_req.pkt->getAddr(), seq_req_list.size(),
                   current_time * clockPeriod(), seq_req.issue_time
                   * clockPeriod(), (current_time * clockPeriod())
                   - (seq_req.issue_time * clockPeriod()));
-        }
-        total_outstanding += table_entry.second.size();
-    }
+        });
+        total_outstanding += seq_req_list.size();
+    });
 
     assert(m_outstanding_count == total_outstanding);
 
@@ -188,12 +190,13 @@ Sequencer::functionalWrite(Packet *func_pkt)
 {
     int num_written = RubyPort::functionalWrite(func_pkt);
 
-    for (const auto &table_entry : m_RequestTable) {
-        for (const auto& seq_req : table_entry.second) {
+    m_RequestTable.forEach([&](Addr addr,
+                               const SequencerRequestList &seq_req_list) {
+        seq_req_list.forEach([&](const SequencerRequest &seq_req) {
             if (seq_req.functionalWrite(func_pkt))
                 ++num_written;
-        }
-    }
+        });
+    });
 
     return num_written;
 }
@@ -241,12 +244,16 @@ Sequencer::insertRequest(PacketPtr pkt, RubyRequestType primary_type,
 
     Addr line_addr = makeLineAddress(pkt->getAddr());
     // Check if there is any outstanding request for the same cache line.
-    auto &seq_req_list = m_RequestTable[line_addr];
+    SequencerRequestList *seq_req_list = m_RequestTable.find(line_addr);
+    if (!seq_req_list) {
+        seq_req_list = &m_RequestTable.insert(line_addr);
+    }
     // Create a default entry
-    seq_req_list.emplace_back(pkt, primary_type, secondary_type, curCycle());
+    seq_req_list->emplace_back(pkt, primary_type, secondary_type,
+                               curCycle());
     m_outstanding_count++;
 
-    if (seq_req_list.size() > 1) {
+    if (seq_req_list->size() > 1) {
         return RequestStatus_Aliased;
     }
 
@@ -346,8 +353,8 @@ Sequencer::writeCallback(Addr address, DataBlock& data,
     // to this cache line when response for the write comes back
     //
     assert(address == makeLineAddress(address));
-    assert(m_RequestTable.find(address) != m_RequestTable.end());
-    auto &seq_req_list = m_RequestTable[address];
+    assert(m_RequestTable.find(address));
+    SequencerRequestList &seq_req_list = *m_RequestTable.find(address);
 
     // Perform hitCallback on every cpu request made to this cache block while
     // ruby request was outstanding. Since only 1 ruby request was made,
@@ -439,8 +446,8 @@ Sequencer::readCallback(Addr address, DataBlock& data,
     // or end of the corresponding list.
     //
     assert(address == makeLineAddress(address));
-    assert(m_RequestTable.find(address) != m_RequestTable.end());
-    auto &seq_req_list = m_RequestTable[address];
+    assert(m_RequestTable.find(address));
+    SequencerRequestList &seq_req_list = *m_RequestTable.find(address);
 
     // Perform hitCallback on every cpu request made to this cache block while
     // ruby request was outstanding. Since only 1 ruby request was made,
@@ -714,16 +721,15 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
     m_mandatory_q_ptr->enqueue(msg, clockEdge(), latency);
 }
 
-template <class KEY, class VALUE>
 std::ostream &
-operator<<(ostream &out, const std::unordered_map<KEY, VALUE> &map)
+operator<<(ostream &out, const FlatAddrMap<SequencerRequestList> &map)
 {
-    for (const auto &table_entry : map) {
-        out << "[ " << table_entry.first << " =";
-        for (const auto &seq_req : table_entry.second) {
+    map.forEach([&](Addr addr, const SequencerRequestList &seq_req_list) {
+        out << "[ " << addr << " =";
+        seq_req_list.forEach([&](const SequencerRequest &seq_req) {
             out << " " << RubyRequestType_to_string(seq_req.m_second_type);
-        }
-    }
+        });
+    });
     out << " ]";
 
     return out;
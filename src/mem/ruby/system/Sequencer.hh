@@ -43,13 +43,15 @@
 
 #include <iostream>
 #include <list>
-#include <unordered_map>
+#include <type_traits>
+#include <utility>
 
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/protocol/MachineType.hh"
 #include "mem/ruby/protocol/RubyRequestType.hh"
 #include "mem/ruby/protocol/SequencerRequestType.hh"
 #include "mem/ruby/structures/CacheMemory.hh"
+#include "mem/ruby/structures/FlatAddrMap.hh"
 #include "mem/ruby/system/RubyPort.hh"
 #include "params/RubySequencer.hh"
 
@@ -77,6 +79,100 @@ struct SequencerRequest
 
 std::ostream& operator<<(std::ostream& out, const SequencerRequest& obj);
 
+/**
+ * FIFO of the requests outstanding for one cache line. Almost every line
+ * only ever has a handful of aliased requests, so the first few are kept
+ * inline and only the rest spill to a std::list. Requests never move once
+ * inserted, so callbacks may enqueue new requests for the same line while
+ * holding a reference to the front one.
+ */
+class SequencerRequestList
+{
+  private:
+    static const int numInline = 4;
+
+    std::aligned_storage<sizeof(SequencerRequest),
+                                  alignof(SequencerRequest)>::type
+        m_inline[numInline];
+    /** Position of the oldest inline request. */
+    int m_head;
+    /** Number of valid inline requests. */
+    int m_numInline;
+    /** Requests that did not fit inline; all younger than inline ones. */
+    std::list<SequencerRequest> m_overflow;
+
+    SequencerRequest &
+    inlineAt(int i)
+    {
+        return *reinterpret_cast<SequencerRequest *>(
+            &m_inline[(m_head + i) % numInline]);
+    }
+
+    const SequencerRequest &
+    inlineAt(int i) const
+    {
+        return *reinterpret_cast<const SequencerRequest *>(
+            &m_inline[(m_head + i) % numInline]);
+    }
+
+  public:
+    SequencerRequestList() : m_head(0), m_numInline(0) {}
+    ~SequencerRequestList() { while (!empty()) pop_front(); }
+
+    SequencerRequestList(const SequencerRequestList &) = delete;
+    SequencerRequestList &operator=(const SequencerRequestList &) = delete;
+
+    bool empty() const { return m_numInline == 0 && m_overflow.empty(); }
+    std::size_t size() const { return m_numInline + m_overflow.size(); }
+
+    SequencerRequest &
+    front()
+    {
+        assert(!empty());
+        return m_numInline ? inlineAt(0) : m_overflow.front();
+    }
+
+    template<class... Args>
+    void
+    emplace_back(Args&&... args)
+    {
+        // Only use the inline slots while nothing has spilled, otherwise
+        // a new request could overtake older ones
+        if (m_numInline < numInline && m_overflow.empty()) {
+            new (&m_inline[(m_head + m_numInline) % numInline])
+                SequencerRequest(std::forward<Args>(args)...);
+            m_numInline++;
+        } else {
+            m_overflow.emplace_back(std::forward<Args>(args)...);
+        }
+    }
+
+    void
+    pop_front()
+    {
+        assert(!empty());
+        if (m_numInline) {
+            inlineAt(0).~SequencerRequest();
+            m_head = (m_head + 1) % numInline;
+            m_numInline--;
+        } else {
+            m_overflow.pop_front();
+        }
+    }
+
+    template<class VISITOR>
+    void
+    forEach(VISITOR &&visitor) const
+    {
+        for (int i = 0; i < m_numInline; i++) {
+            visitor(inlineAt(i));
+        }
+        for (const auto &seq_req : m_overflow) {
+            visitor(seq_req);
+        }
+    }
+};
+
 class Sequencer : public RubyPort
 {
   public:
@@ -217,7 +313,7 @@ class Sequencer : public RubyPort
     Cycles m_inst_cache_hit_latency;
 
     // RequestTable contains both read and write requests, handles aliasing
-    std::unordered_map<Addr, std::list<SequencerRequest>> m_RequestTable;
+    FlatAddrMap<SequencerRequestList> m_RequestTable;
 
     // Global outstanding request count, across all request tables
     int m_outstanding_count;
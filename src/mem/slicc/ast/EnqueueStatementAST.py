@@ -56,7 +56,8 @@ class EnqueueStatementAST(StatementAST):
 
         # Declare message
         code("std::shared_ptr<${{msg_type.c_ident}}> out_msg = "\
-             "std::make_shared<${{msg_type.c_ident}}>(clockEdge());")
+             "std::allocate_shared<${{msg_type.c_ident}}>("\
+             "MessageAllocator<${{msg_type.c_ident}}>(), clockEdge());")
 
         # The other statements
         t = self.statements.generate(code, None)
@@ -73,6 +73,9 @@ def main(args=None):
                       help="print traceback on error")
     parser.add_option("-q", "--quiet",
                       help="don't print messages")
+    parser.add_option("--flat-transitions", action='store_true',
+                      help="generate the transition table in the same "
+                           "translation unit as the actions")
     opts,files = parser.parse_args(args=args)
 
     if len(files) != 1:
@@ -93,7 +96,7 @@ def main(args=None):
     protocol_base = os.path.join(os.path.dirname(__file__),
                                  '..', 'ruby', 'protocol')
     slicc = SLICC(slicc_file, protocol_base, verbose=True, debug=opts.debug,
-                  traceback=opts.tb)
+                  traceback=opts.tb, flat_transitions=opts.flat_transitions)
 
 
     if opts.print_files:
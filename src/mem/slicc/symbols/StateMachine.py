@@ -105,6 +105,7 @@ class StateMachine(Symbol):
         self.TBEType   = None
         self.EntryType = None
         self.debug_flags = set()
+        self.debug_flags.add('ProtocolTrace')
         self.debug_flags.add('RubyGenerated')
         self.debug_flags.add('RubySlicc')
 
@@ -545,8 +546,15 @@ std::vector<std::vector<Stats::Vector *> >  $c_ident::transVec;
 // for adding information to the protocol debug trace
 stringstream ${ident}_transitionComment;
 
+// The comment is only printed by the ProtocolTrace flag, so do not pay
+// for formatting it otherwise
 #ifndef NDEBUG
-#define APPEND_TRANSITION_COMMENT(str) (${ident}_transitionComment << str)
+#define APPEND_TRANSITION_COMMENT(str) \\
+    do { \\
+        if (DTRACE(ProtocolTrace)) { \\
+            ${ident}_transitionComment << str; \\
+        } \\
+    } while (0)
 #else
 #define APPEND_TRANSITION_COMMENT(str) do {} while (0)
 #endif
@@ -1131,6 +1139,11 @@ $c_ident::functionalReadBuffers(PacketPtr& pkt)
 }
 ''')
 
+        # Generate the transition table along with the actions, so that
+        # the compiler can inline them into the transitions
+        if self.symtab.slicc.flat_transitions:
+            self.printTransitions(code)
+
         code.write(path, "%s.cc" % c_ident)
 
     def printCWakeup(self, path, includes):
@@ -1268,6 +1281,17 @@ ${ident}_Controller::wakeup()
         code = self.symtab.codeFormatter()
         ident = self.ident
 
+        # With flat transitions the table is generated along with the
+        # actions, in the controller's translation unit
+        if self.symtab.slicc.flat_transitions:
+            code('''
+// Auto generated C++ code started by $__file__:$__line__
+// ${ident}: ${{self.short}}
+// The transition table is generated in ${ident}_Controller.cc
+''')
+            code.write(path, "%s_Transitions.cc" % self.ident)
+            return
+
         code('''
 // Auto generated C++ code started by $__file__:$__line__
 // ${ident}: ${{self.short}}
@@ -1283,8 +1307,18 @@ ${ident}_Controller::wakeup()
 #include "mem/ruby/protocol/${ident}_State.hh"
 #include "mem/ruby/protocol/Types.hh"
 #include "mem/ruby/system/RubySystem.hh"
+''')
+        self.printTransitions(code)
+        code.write(path, "%s_Transitions.cc" % self.ident)
+
+    def printTransitions(self, code):
+        '''Output the transition functions, dispatching through a switch
+        on the (state, event) pair'''
+
+        ident = self.ident
 
-#define HASH_FUN(state, event)  ((int(state)*${ident}_Event_NUM)+int(event))
+        code()
+        code('''#define HASH_FUN(state, event)  ((int(state)*${ident}_Event_NUM)+int(event))
 
 #define GET_TRANSITION_COMMENT() (${ident}_transitionComment.str())
 #define CLEAR_TRANSITION_COMMENT() (${ident}_transitionComment.str(""))
@@ -1513,7 +1547,6 @@ if (!checkResourceAvailable(%s_RequestType_%s, addr)) {
     return TransitionResult_Valid;
 }
 ''')
-        code.write(path, "%s_Transitions.cc" % self.ident)
 
 
     # **************************
@@ -298,7 +298,8 @@ $klass ${{self.c_ident}}$parent
 MsgPtr
 clone() const
 {
-     return std::shared_ptr<Message>(new ${{self.c_ident}}(*this));
+     return std::allocate_shared<${{self.c_ident}}>(
+         MessageAllocator<${{self.c_ident}}>(), *this);
 }
 ''')
         else:
@@ -42,9 +42,10 @@
 using namespace std;
 using namespace google::protobuf;
 
-ProtoOutputStream::ProtoOutputStream(const string& filename) :
+ProtoOutputStream::ProtoOutputStream(const string& filename, bool background) :
     fileStream(filename.c_str(), ios::out | ios::binary | ios::trunc),
-    wrappedFileStream(NULL), gzipStream(NULL), zeroCopyStream(NULL)
+    wrappedFileStream(NULL), gzipStream(NULL), zeroCopyStream(NULL),
+    pendingBatches(0), stopWriter(false)
 {
     if (!fileStream.good())
         panic("Could not open %s for writing\n", filename);
@@ -62,15 +63,34 @@ ProtoOutputStream::ProtoOutputStream(const string& filename) :
     }
 
     // Write the magic number to the file
-    io::CodedOutputStream codedStream(zeroCopyStream);
-    codedStream.WriteLittleEndian32(magicNumber);
+    {
+        io::CodedOutputStream codedStream(zeroCopyStream);
+        codedStream.WriteLittleEndian32(magicNumber);
+    }
 
     // Note that each type of stream (packet, instruction etc) should
     // add its own header and perform the appropriate checks
+
+    currentBatch.reserve(batchSize);
+    if (background)
+        writerThread = thread([this] { writerMain(); });
 }
 
 ProtoOutputStream::~ProtoOutputStream()
 {
+    // Write out whatever is left and let the writer thread drain the
+    // queue before tearing down the streams it uses
+    if (!currentBatch.empty())
+        flushBatch();
+    if (writerThread.joinable()) {
+        {
+            lock_guard<mutex> lock(queueLock);
+            stopWriter = true;
+        }
+        batchReady.notify_one();
+        writerThread.join();
+    }
+
     // As the compression is optional, see if the stream exists
     if (gzipStream != NULL)
         delete gzipStream;
@@ -81,21 +101,83 @@ ProtoOutputStream::~ProtoOutputStream()
 void
 ProtoOutputStream::write(const Message& msg)
 {
-    // Due to the byte limit of the coded stream we create it for
-    // every single mesage (based on forum discussions around the size
-    // limitation)
-    io::CodedOutputStream codedStream(zeroCopyStream);
-
-    // Write the size of the message to the stream
+    // Get the size of the message, which also caches the sizes needed
+    // to serialise it
 #   if GOOGLE_PROTOBUF_VERSION < 3001000
         auto msg_size = msg.ByteSize();
 #   else
         auto msg_size = msg.ByteSizeLong();
 #   endif
-    codedStream.WriteVarint32(msg_size);
+    size_t needed = io::CodedOutputStream::VarintSize32(msg_size) + msg_size;
+
+    if (!currentBatch.empty() && currentBatch.size() + needed > batchSize)
+        flushBatch();
+
+    // Write the size of the message followed by the message itself
+    size_t offset = currentBatch.size();
+    currentBatch.resize(offset + needed);
+    uint8_t *target = currentBatch.data() + offset;
+    target = io::CodedOutputStream::WriteVarint32ToArray(msg_size, target);
+    msg.SerializeWithCachedSizesToArray(target);
+}
+
+void
+ProtoOutputStream::flushBatch()
+{
+    if (!writerThread.joinable()) {
+        writeBatch(currentBatch);
+        currentBatch.clear();
+        return;
+    }
+
+    unique_lock<mutex> lock(queueLock);
+    batchFree.wait(lock, [this] { return pendingBatches < maxBatches; });
+    fullBatches.push_back(std::move(currentBatch));
+    pendingBatches++;
+    if (!freeBatches.empty()) {
+        currentBatch = std::move(freeBatches.back());
+        freeBatches.pop_back();
+    } else {
+        currentBatch = Batch();
+        currentBatch.reserve(batchSize);
+    }
+    lock.unlock();
+    batchReady.notify_one();
+}
+
+void
+ProtoOutputStream::writeBatch(const Batch& batch)
+{
+    // Due to the byte limit of the coded stream we create it for
+    // every batch (based on forum discussions around the size
+    // limitation)
+    io::CodedOutputStream codedStream(zeroCopyStream);
+    codedStream.WriteRaw(batch.data(), batch.size());
+}
 
-    // Write the message itself to the stream
-    msg.SerializeWithCachedSizes(&codedStream);
+void
+ProtoOutputStream::writerMain()
+{
+    unique_lock<mutex> lock(queueLock);
+    while (true) {
+        batchReady.wait(lock, [this] {
+            return !fullBatches.empty() || stopWriter;
+        });
+        if (fullBatches.empty())
+            return;
+
+        Batch batch = std::move(fullBatches.front());
+        fullBatches.pop_front();
+        lock.unlock();
+
+        writeBatch(batch);
+        batch.clear();
+
+        lock.lock();
+        freeBatches.push_back(std::move(batch));
+        pendingBatches--;
+        batchFree.notify_one();
+    }
 }
 
 ProtoInputStream::ProtoInputStream(const string& filename) :
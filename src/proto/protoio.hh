@@ -49,7 +49,13 @@
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/message.h>
 
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 /**
  * A ProtoStream provides the shared functionality of the input and
@@ -86,6 +92,13 @@ class ProtoStream
  * basis to avoid having to deal with huge data structures. The latter
  * is made possible by encoding the length of each message in the
  * stream.
+ *
+ * Messages are serialised into batches in memory. By default, full
+ * batches are handed to a writer thread that compresses them and
+ * writes them to the file, so the caller only pays for the
+ * serialisation. The number of batches in flight is bounded, and
+ * writing blocks when the writer thread falls behind. The bytes that
+ * end up in the file are the same as when writing synchronously.
  */
 class ProtoOutputStream : public ProtoStream
 {
@@ -97,8 +110,9 @@ class ProtoOutputStream : public ProtoStream
      * ends with .gz then the file will be compressed accordinly.
      *
      * @param filename Path to the file to create or truncate
+     * @param background Compress and write batches on a writer thread
      */
-    ProtoOutputStream(const std::string& filename);
+    ProtoOutputStream(const std::string& filename, bool background = true);
 
     /**
      * Destruct the output stream, and also flush and close the
@@ -116,6 +130,30 @@ class ProtoOutputStream : public ProtoStream
 
   private:
 
+    typedef std::vector<uint8_t> Batch;
+
+    /// Size at which a batch of serialised messages is written out
+    static const size_t batchSize = 1 << 20;
+
+    /// Maximum number of batches queued for or held by the writer
+    static const size_t maxBatches = 4;
+
+    /**
+     * Hand the current batch over to the writer thread, or write it
+     * directly if there is none.
+     */
+    void flushBatch();
+
+    /**
+     * Write a batch to the file through the top-level stream.
+     */
+    void writeBatch(const Batch& batch);
+
+    /**
+     * Main loop of the writer thread.
+     */
+    void writerMain();
+
     /// Underlying file output stream
     std::ofstream fileStream;
 
@@ -128,6 +166,32 @@ class ProtoOutputStream : public ProtoStream
     /// Top-level zero-copy stream, either with compression or not
     google::protobuf::io::ZeroCopyOutputStream* zeroCopyStream;
 
+    /// Batch the messages are currently serialised into
+    Batch currentBatch;
+
+    /// Writer thread, only started in background mode
+    std::thread writerThread;
+
+    /// Protects the batch queues and the stop flag
+    std::mutex queueLock;
+
+    /// Signalled when a batch is queued or the writer must stop
+    std::condition_variable batchReady;
+
+    /// Signalled when the writer is done with a batch
+    std::condition_variable batchFree;
+
+    /// Batches waiting to be written, in message order
+    std::deque<Batch> fullBatches;
+
+    /// Written batches, kept to avoid reallocating their storage
+    std::vector<Batch> freeBatches;
+
+    /// Batches queued or being written
+    size_t pendingBatches;
+
+    /// Set to ask the writer thread to finish once the queue is empty
+    bool stopWriter;
 };
 
 /**
@@ -0,0 +1,123 @@
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+'''
+Records the branches of an O3 run of hello world with the BranchTrace
+probe, replays the trace against the predictor of that CPU with
+bpred_trace_eval.py, and checks that the replay mispredicts about as often
+as the CPU did.
+'''
+
+import sys
+
+from testlib import *
+from testlib import test_util as test
+from testlib.helper import log_call
+
+# Where the predictors of the O3 CPU and of the replay part ways: the CPU
+# updates its predictor when branches commit, not when they are predicted,
+# and decode corrects direct branches missing in the BTB before they are
+# counted as mispredicted at commit.
+tolerance = 0.15
+
+if config.bin_path:
+    base_path = config.bin_path
+else:
+    base_path = joinpath(absdirpath(__file__), '..', 'test-progs', 'hello',
+        'bin')
+
+url = config.resource_url + '/test-progs/hello/bin/x86/linux/hello64-static'
+path = joinpath(base_path, 'x86', 'linux')
+hello_program = DownloadedProgram(url, path, 'hello64-static')
+
+trace_file = 'branches.gz'
+trace_path = 'system.cpu.branchTraceListener.' + trace_file
+
+def read_stats(stats_file, names):
+    '''Return the values of the given statistics in a stats.txt file.'''
+    values = {}
+    with open(stats_file, 'r') as stats:
+        for line in stats:
+            fields = line.split()
+            if len(fields) > 1 and fields[0] in names:
+                values[fields[0]] = float(fields[1])
+    missing = set(names) - set(values)
+    if missing:
+        test.fail('Missing statistics in %s: %s' %
+                  (stats_file, ', '.join(sorted(missing))))
+    return values
+
+class MatchReplayMPKI(verifier.Verifier):
+    '''
+    Replays the branch trace of the gem5 run and compares its MPKI with
+    the one of the run.
+    '''
+    def test(self, params):
+        fixtures = params.fixtures
+        tempdir = fixtures[constants.tempdir_fixture_name].path
+        gem5 = fixtures[constants.gem5_binary_fixture_name].path
+
+        cpu = read_stats(joinpath(tempdir, constants.gem5_simulation_stats),
+                         ('system.cpu.committedInsts',
+                          'system.cpu.commit.branchMispredicts'))
+        cpu_mpki = 1000.0 * cpu['system.cpu.commit.branchMispredicts'] / \
+            cpu['system.cpu.committedInsts']
+
+        replay_dir = joinpath(tempdir, 'replay')
+        returncode = log_call(params.log, [
+            gem5, '-d', replay_dir, '-re',
+            joinpath(config.base_dir, 'configs', 'example',
+                     'bpred_trace_eval.py'),
+            '--trace-file', joinpath(tempdir, trace_path),
+            '--bp-types', 'TournamentBP',
+        ], stdout=sys.stdout, stderr=sys.stderr)
+        if returncode != 0:
+            test.fail('Replay of the branch trace failed')
+
+        replay = read_stats(
+            joinpath(replay_dir, constants.gem5_simulation_stats),
+            ('bpred_eval.insts', 'bpred_eval.mispredicts'))
+        replay_mpki = 1000.0 * replay['bpred_eval.mispredicts'] / \
+            replay['bpred_eval.insts']
+
+        if replay['bpred_eval.insts'] != cpu['system.cpu.committedInsts']:
+            test.fail('Replay covers %d instructions, the run %d' %
+                      (replay['bpred_eval.insts'],
+                       cpu['system.cpu.committedInsts']))
+        if abs(replay_mpki - cpu_mpki) > tolerance * cpu_mpki:
+            test.fail('Replay MPKI %.4f, O3 MPKI %.4f' %
+                      (replay_mpki, cpu_mpki))
+
+gem5_verify_config(
+    name='test-bpred-trace-replay',
+    fixtures=(hello_program,),
+    verifiers=(MatchReplayMPKI(),),
+    config=joinpath(config.base_dir, 'configs', 'example', 'se.py'),
+    config_args=['--cmd', joinpath(path, 'hello64-static'),
+                 '--cpu-type', 'DerivO3CPU', '--caches',
+                 '--branch-trace-file', trace_file],
+    valid_isas=('X86',),
+)
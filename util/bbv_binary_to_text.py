@@ -0,0 +1,81 @@
+#!/usr/bin/env python
+
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script converts the binary basic block vectors written by the
+# SimPoint probe with binary_profile enabled back to the text format
+# read by the SimPoint tool. The layout is described in
+# src/cpu/simple/probes/simpoint.hh.
+
+from __future__ import print_function
+
+import gzip
+import sys
+
+binary_magic = b'gem5BBV1'
+
+def read_varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        byte = bytearray(data[pos:pos + 1])[0]
+        pos += 1
+        value |= (byte & 0x7f) << shift
+        if not byte & 0x80:
+            return value, pos
+        shift += 7
+
+def main():
+    if len(sys.argv) != 3:
+        print("Usage: ", sys.argv[0], " <binary input> <text output>")
+        exit(-1)
+
+    in_name, out_name = sys.argv[1:]
+    opener = gzip.open if in_name.endswith('.gz') else open
+    with opener(in_name, 'rb') as f:
+        data = f.read()
+
+    if data[:len(binary_magic)] != binary_magic:
+        print("Input is not a binary BBV file")
+        exit(-1)
+
+    out_opener = gzip.open if out_name.endswith('.gz') else open
+    with out_opener(out_name, 'wt') as out:
+        pos = len(binary_magic)
+        while pos < len(data):
+            entries, pos = read_varint(data, pos)
+            bb_id = 0
+            line = ["T"]
+            for _ in range(entries):
+                delta, pos = read_varint(data, pos)
+                count, pos = read_varint(data, pos)
+                bb_id += delta
+                line.append(":%d:%d " % (bb_id, count))
+            out.write("".join(line) + "\n")
+
+if __name__ == "__main__":
+    main()